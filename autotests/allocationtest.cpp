@@ -0,0 +1,187 @@
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breezeallocationcounter.h"
+#include "breezebutton.h"
+#include "breezedecoration.h"
+#include "mockbridge.h"
+
+#include <QImage>
+#include <QPainter>
+#include <QStandardPaths>
+#include <QTest>
+
+#include <functional>
+#include <memory>
+
+using namespace SierraBreeze;
+
+//* steady-state repaints of decorations and buttons must not allocate
+/**
+runs with libsierrabreeze_allocationhooks preloaded. Decorations and buttons are painted twice,
+to fill their caches, before the allocations of a third paint are counted
+*/
+class AllocationTest: public QObject
+{
+
+    Q_OBJECT
+
+    private Q_SLOTS:
+
+    void initTestCase();
+
+    void decoration_data();
+    void decoration();
+
+    void button_data();
+    void button();
+
+    private:
+
+    //* allocations of a paint, with caches warm
+    static quint64 allocations( const std::function<void(QPainter*)>&, const QSize& );
+
+    //* bridge
+    std::unique_ptr<MockBridge> m_bridge;
+
+};
+
+//__________________________________________________________________
+void AllocationTest::initTestCase()
+{
+    QVERIFY2( AllocationCounter::isAvailable(), "libsierrabreeze_allocationhooks is not preloaded" );
+
+    QStandardPaths::setTestModeEnabled( true );
+    m_bridge = std::make_unique<MockBridge>();
+}
+
+//__________________________________________________________________
+void AllocationTest::decoration_data()
+{
+
+    QTest::addColumn<bool>( "active" );
+    QTest::addColumn<bool>( "maximized" );
+    QTest::addColumn<QString>( "caption" );
+
+    QTest::newRow( "active" ) << true << false << QString();
+    QTest::newRow( "inactive" ) << false << false << QString();
+    QTest::newRow( "maximized" ) << true << true << QString();
+    QTest::newRow( "caption" ) << true << false << QStringLiteral( "Konsole" );
+
+}
+
+//__________________________________________________________________
+void AllocationTest::decoration()
+{
+
+    QFETCH( bool, active );
+    QFETCH( bool, maximized );
+    QFETCH( QString, caption );
+
+    MockWindow window;
+    window.active = active;
+    window.maximized = maximized;
+    window.caption = caption;
+    const std::unique_ptr<Decoration> decoration( m_bridge->createDecoration( window ) );
+
+    // let the buttons be laid out
+    QCoreApplication::processEvents();
+
+    const QRect rect( QPoint( 0, 0 ), decoration->size() );
+    QCOMPARE( allocations( [&decoration, &rect]( QPainter* painter ) { decoration->paint( painter, rect ); }, rect.size() ), quint64( 0 ) );
+
+}
+
+//__________________________________________________________________
+void AllocationTest::button_data()
+{
+
+    QTest::addColumn<int>( "type" );
+    QTest::addColumn<bool>( "active" );
+
+    const struct { KDecoration2::DecorationButtonType type; const char* name; } types[] = {
+        { KDecoration2::DecorationButtonType::Menu, "menu" },
+        { KDecoration2::DecorationButtonType::OnAllDesktops, "onalldesktops" },
+        { KDecoration2::DecorationButtonType::Minimize, "minimize" },
+        { KDecoration2::DecorationButtonType::Maximize, "maximize" },
+        { KDecoration2::DecorationButtonType::Close, "close" },
+        { KDecoration2::DecorationButtonType::ContextHelp, "contexthelp" },
+        { KDecoration2::DecorationButtonType::Shade, "shade" },
+        { KDecoration2::DecorationButtonType::KeepBelow, "keepbelow" },
+        { KDecoration2::DecorationButtonType::KeepAbove, "keepabove" } };
+
+    for( const auto& type : types )
+    {
+        QTest::newRow( qPrintable( QStringLiteral( "%1-active" ).arg( QLatin1String( type.name ) ) ) ) << int( type.type ) << true;
+        QTest::newRow( qPrintable( QStringLiteral( "%1-inactive" ).arg( QLatin1String( type.name ) ) ) ) << int( type.type ) << false;
+    }
+
+}
+
+//__________________________________________________________________
+void AllocationTest::button()
+{
+
+    QFETCH( int, type );
+    QFETCH( bool, active );
+
+    MockWindow window;
+    window.active = active;
+    const std::unique_ptr<Decoration> decoration( m_bridge->createDecoration( window ) );
+    QCoreApplication::processEvents();
+
+    const std::unique_ptr<Button> button( Button::create( KDecoration2::DecorationButtonType( type ), decoration.get(), nullptr ) );
+    QVERIFY( button );
+    button->setVisible( true );
+
+    const QRect rect( button->geometry().toAlignedRect() );
+    QCOMPARE( allocations( [&button, &rect]( QPainter* painter ) { button->paint( painter, rect ); }, rect.size() + QSize( rect.x(), rect.y() ) ), quint64( 0 ) );
+
+}
+
+//__________________________________________________________________
+quint64 AllocationTest::allocations( const std::function<void(QPainter*)>& function, const QSize& size )
+{
+
+    // the painter is set up beforehand, only the paint itself is counted
+    QImage image( size, QImage::Format_ARGB32_Premultiplied );
+    image.fill( Qt::transparent );
+    QPainter painter( &image );
+
+    for( int i = 0; i < 2; ++i )
+    {
+        painter.save();
+        function( &painter );
+        painter.restore();
+    }
+
+    painter.save();
+    const quint64 start( AllocationCounter::count() );
+    function( &painter );
+    const quint64 count( AllocationCounter::count() - start );
+    painter.restore();
+
+    return count;
+
+}
+
+QTEST_MAIN( AllocationTest )
+
+#include "allocationtest.moc"
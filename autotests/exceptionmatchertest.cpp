@@ -0,0 +1,108 @@
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breezeexceptionmatcher.h"
+
+#include <QRegularExpression>
+#include <QTest>
+
+using namespace SierraBreeze;
+
+//* required literals of regular expressions, checked against what the expressions actually match
+class ExceptionMatcherTest: public QObject
+{
+
+    Q_OBJECT
+
+    private Q_SLOTS:
+
+    void requiredLiteral_data();
+    void requiredLiteral();
+
+};
+
+//__________________________________________________________________
+void ExceptionMatcherTest::requiredLiteral_data()
+{
+
+    QTest::addColumn<QString>( "pattern" );
+    QTest::addColumn<QString>( "literal" );
+    QTest::addColumn<QStringList>( "samples" );
+
+    // plain text and escaped characters
+    QTest::newRow( "plain" ) << QStringLiteral( "konsole" ) << QStringLiteral( "konsole" ) << QStringList{ QStringLiteral( "konsole org.kde.konsole" ) };
+    QTest::newRow( "escaped" ) << QStringLiteral( "^org\\.kde\\." ) << QStringLiteral( "org.kde." ) << QStringList{ QStringLiteral( "org.kde.dolphin" ) };
+
+    // quantifiers
+    QTest::newRow( "optional" ) << QStringLiteral( "colou?r" ) << QStringLiteral( "colo" ) << QStringList{ QStringLiteral( "color" ), QStringLiteral( "colour" ) };
+    QTest::newRow( "repeated" ) << QStringLiteral( "ab+c" ) << QStringLiteral( "ab" ) << QStringList{ QStringLiteral( "abc" ), QStringLiteral( "abbbc" ) };
+    QTest::newRow( "counted class" ) << QStringLiteral( "[0-9]{4}" ) << QString() << QStringList{ QStringLiteral( "Report 2026" ), QStringLiteral( "1999" ) };
+    QTest::newRow( "counted range" ) << QStringLiteral( "xy{2,3}" ) << QStringLiteral( "x" ) << QStringList{ QStringLiteral( "xyy" ), QStringLiteral( "xyyy" ) };
+    QTest::newRow( "counted escapes" ) << QStringLiteral( "\\d{2}:\\d{2}" ) << QStringLiteral( ":" ) << QStringList{ QStringLiteral( "12:30" ) };
+    QTest::newRow( "counted group" ) << QStringLiteral( "(ab){2}cd" ) << QStringLiteral( "cd" ) << QStringList{ QStringLiteral( "ababcd" ) };
+    QTest::newRow( "literal brace" ) << QStringLiteral( "a{b}" ) << QStringLiteral( "b" ) << QStringList{ QStringLiteral( "a{b}" ) };
+
+    // escapes with arguments
+    QTest::newRow( "property" ) << QStringLiteral( "\\p{Greek}+" ) << QString() << QStringList{ QStringLiteral( "αβγ" ) };
+    QTest::newRow( "short property" ) << QStringLiteral( "\\pLxyz" ) << QStringLiteral( "xyz" ) << QStringList{ QStringLiteral( "Axyz" ) };
+    QTest::newRow( "negated property" ) << QStringLiteral( "\\P{L}ab" ) << QStringLiteral( "ab" ) << QStringList{ QStringLiteral( "1ab" ) };
+    QTest::newRow( "hexadecimal" ) << QStringLiteral( "\\x41BC" ) << QStringLiteral( "BC" ) << QStringList{ QStringLiteral( "ABC" ) };
+    QTest::newRow( "braced hexadecimal" ) << QStringLiteral( "\\x{41}BC" ) << QStringLiteral( "BC" ) << QStringList{ QStringLiteral( "ABC" ) };
+    QTest::newRow( "octal" ) << QStringLiteral( "\\o{101}BC" ) << QStringLiteral( "BC" ) << QStringList{ QStringLiteral( "ABC" ) };
+    QTest::newRow( "numeric octal" ) << QStringLiteral( "\\101BC" ) << QStringLiteral( "BC" ) << QStringList{ QStringLiteral( "ABC" ) };
+    QTest::newRow( "named character" ) << QStringLiteral( "\\N{U+41}BC" ) << QStringLiteral( "BC" ) << QStringList{ QStringLiteral( "ABC" ) };
+    QTest::newRow( "control" ) << QStringLiteral( "\\cIxyz" ) << QStringLiteral( "xyz" ) << QStringList{ QStringLiteral( "\txyz" ) };
+    QTest::newRow( "numbered reference" ) << QStringLiteral( "(a)\\g1bc" ) << QStringLiteral( "bc" ) << QStringList{ QStringLiteral( "aabc" ) };
+    QTest::newRow( "braced reference" ) << QStringLiteral( "(a)\\g{-1}bc" ) << QStringLiteral( "bc" ) << QStringList{ QStringLiteral( "aabc" ) };
+    QTest::newRow( "named reference" ) << QStringLiteral( "(?<n>a)\\k<n>bc" ) << QString() << QStringList{ QStringLiteral( "aabc" ) };
+    QTest::newRow( "quoted subroutine" ) << QStringLiteral( "(a)\\g'1'bc" ) << QStringLiteral( "bc" ) << QStringList{ QStringLiteral( "aabc" ) };
+
+    // groups, alternatives and options
+    QTest::newRow( "group" ) << QStringLiteral( "(\\w+) - Mozilla" ) << QStringLiteral( " - Mozilla" ) << QStringList{ QStringLiteral( "Start Page - Mozilla" ) };
+    QTest::newRow( "optional group" ) << QStringLiteral( "fire(fox)?" ) << QStringLiteral( "fire" ) << QStringList{ QStringLiteral( "fire" ), QStringLiteral( "firefox" ) };
+    QTest::newRow( "alternative" ) << QStringLiteral( "abc|def" ) << QString() << QStringList{ QStringLiteral( "def" ) };
+    QTest::newRow( "case insensitive" ) << QStringLiteral( "(?i)konsole" ) << QString() << QStringList{ QStringLiteral( "Konsole" ) };
+
+}
+
+//__________________________________________________________________
+void ExceptionMatcherTest::requiredLiteral()
+{
+
+    QFETCH( QString, pattern );
+    QFETCH( QString, literal );
+    QFETCH( QStringList, samples );
+
+    QCOMPARE( ExceptionMatcher::requiredLiteral( pattern ), literal );
+
+    // every match must contain the literal, or the prefilter would skip a matching rule
+    const QRegularExpression expression( pattern );
+    QVERIFY2( expression.isValid(), qPrintable( expression.errorString() ) );
+    for( const QString& sample : samples )
+    {
+        QVERIFY2( expression.match( sample ).hasMatch(), qPrintable( sample ) );
+        QVERIFY2( sample.contains( literal ), qPrintable( sample ) );
+    }
+
+}
+
+QTEST_GUILESS_MAIN( ExceptionMatcherTest )
+
+#include "exceptionmatchertest.moc"
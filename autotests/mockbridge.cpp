@@ -0,0 +1,194 @@
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mockbridge.h"
+#include "breezedecoration.h"
+
+#include <KDecoration2/Private/DecoratedClientPrivate>
+#include <KDecoration2/Private/DecorationSettingsPrivate>
+
+#include <QFont>
+#include <QIcon>
+#include <QPalette>
+
+namespace SierraBreeze
+{
+
+    namespace
+    {
+
+        //* client with fixed state
+        class MockClient: public KDecoration2::DecoratedClientPrivate
+        {
+
+            public:
+
+            //* constructor
+            MockClient( KDecoration2::DecoratedClient* client, KDecoration2::Decoration* decoration, const MockWindow& window ):
+                DecoratedClientPrivate( client, decoration ),
+                m_window( window )
+            {}
+
+            //*@name state
+            //@{
+
+            bool isActive() const override { return m_window.active; }
+            QString caption() const override { return m_window.caption; }
+            bool isOnAllDesktops() const override { return false; }
+            bool isShaded() const override { return false; }
+            QIcon icon() const override { return QIcon(); }
+            bool isMaximized() const override { return m_window.maximized; }
+            bool isMaximizedHorizontally() const override { return m_window.maximized; }
+            bool isMaximizedVertically() const override { return m_window.maximized; }
+            bool isKeepAbove() const override { return false; }
+            bool isKeepBelow() const override { return false; }
+            bool isCloseable() const override { return true; }
+            bool isMaximizeable() const override { return true; }
+            bool isMinimizeable() const override { return true; }
+            bool providesContextHelp() const override { return true; }
+            bool isModal() const override { return false; }
+            bool isShadeable() const override { return true; }
+            bool isMoveable() const override { return true; }
+            bool isResizeable() const override { return true; }
+            WId windowId() const override { return 0; }
+            WId decorationId() const override { return 0; }
+            int width() const override { return m_window.size.width(); }
+            int height() const override { return m_window.size.height(); }
+            QSize size() const override { return m_window.size; }
+            Qt::Edges adjacentScreenEdges() const override { return Qt::Edges(); }
+
+            //@}
+
+            //*@name colors
+            //@{
+
+            QPalette palette() const override
+            { return QPalette( QColor( 239, 240, 241 ) ); }
+
+            QColor color( KDecoration2::ColorGroup group, KDecoration2::ColorRole role ) const override
+            {
+                const bool active( group == KDecoration2::ColorGroup::Active );
+                switch( role )
+                {
+                    case KDecoration2::ColorRole::Frame:
+                    case KDecoration2::ColorRole::TitleBar:
+                    return active ? QColor( 71, 80, 87 ) : QColor( 239, 240, 241 );
+
+                    case KDecoration2::ColorRole::Foreground:
+                    return active ? QColor( 252, 252, 252 ) : QColor( 189, 195, 199 );
+
+                    default: return QColor();
+                }
+            }
+
+            //@}
+
+            //*@name requests, ignored
+            //@{
+
+            void requestShowToolTip( const QString& ) override {}
+            void requestHideToolTip() override {}
+            void requestClose() override {}
+            void requestToggleMaximization( Qt::MouseButtons ) override {}
+            void requestMinimize() override {}
+            void requestContextHelp() override {}
+            void requestToggleOnAllDesktops() override {}
+            void requestToggleShade() override {}
+            void requestToggleKeepAbove() override {}
+            void requestToggleKeepBelow() override {}
+            void requestShowWindowMenu( const QRect& ) override {}
+
+            //@}
+
+            private:
+
+            MockWindow m_window;
+
+        };
+
+        //* settings with fixed font and button layout
+        class MockSettings: public KDecoration2::DecorationSettingsPrivate
+        {
+
+            public:
+
+            //* constructor
+            explicit MockSettings( KDecoration2::DecorationSettings* parent ):
+                DecorationSettingsPrivate( parent )
+            {}
+
+            bool isOnAllDesktopsAvailable() const override { return true; }
+            bool isAlphaChannelSupported() const override { return true; }
+            bool isCloseOnDoubleClickOnMenu() const override { return false; }
+            KDecoration2::BorderSize borderSize() const override { return KDecoration2::BorderSize::Normal; }
+            QFont font() const override { return QFont( QStringLiteral( "Sans Serif" ), 10 ); }
+
+            QList<KDecoration2::DecorationButtonType> decorationButtonsLeft() const override
+            {
+                return {
+                    KDecoration2::DecorationButtonType::Close,
+                    KDecoration2::DecorationButtonType::Minimize,
+                    KDecoration2::DecorationButtonType::Maximize };
+            }
+
+            QList<KDecoration2::DecorationButtonType> decorationButtonsRight() const override
+            {
+                return {
+                    KDecoration2::DecorationButtonType::OnAllDesktops,
+                    KDecoration2::DecorationButtonType::ContextHelp };
+            }
+
+        };
+
+    }
+
+    //________________________________________________________________
+    MockBridge::MockBridge( QObject* parent ):
+        DecorationBridge( parent )
+    {}
+
+    //________________________________________________________________
+    MockBridge::~MockBridge() = default;
+
+    //________________________________________________________________
+    std::unique_ptr<Decoration> MockBridge::createDecoration( const MockWindow& window )
+    {
+
+        // the client is created by the decoration constructor
+        m_window = window;
+        const QVariantMap arguments{ { QStringLiteral( "bridge" ), QVariant::fromValue( static_cast<KDecoration2::DecorationBridge*>( this ) ) } };
+        std::unique_ptr<Decoration> decoration( new Decoration( nullptr, QVariantList{ arguments } ) );
+
+        if( !m_settings ) m_settings = std::make_shared<KDecoration2::DecorationSettings>( this );
+        decoration->setSettings( m_settings );
+        decoration->init();
+        return decoration;
+
+    }
+
+    //________________________________________________________________
+    std::unique_ptr<KDecoration2::DecoratedClientPrivate> MockBridge::createClient( KDecoration2::DecoratedClient* client, KDecoration2::Decoration* decoration )
+    { return std::make_unique<MockClient>( client, decoration, m_window ); }
+
+    //________________________________________________________________
+    std::unique_ptr<KDecoration2::DecorationSettingsPrivate> MockBridge::settings( KDecoration2::DecorationSettings* parent )
+    { return std::make_unique<MockSettings>( parent ); }
+
+}
@@ -0,0 +1,91 @@
+#ifndef mockbridge_h
+#define mockbridge_h
+
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <KDecoration2/DecorationSettings>
+#include <KDecoration2/Private/DecorationBridge>
+
+#include <QSize>
+#include <QString>
+
+#include <memory>
+
+namespace SierraBreeze
+{
+
+    class Decoration;
+
+    //* state of the window a mock client stands for
+    struct MockWindow
+    {
+        bool active = true;
+        bool maximized = false;
+        QSize size = QSize( 320, 200 );
+
+        //* empty by default, so that renderings do not depend on the fonts installed
+        QString caption;
+    };
+
+    //* decoration bridge standing for kwin, so that decorations can be created and painted offscreen
+    /**
+    clients have a fixed palette and colors, and settings a fixed font and button layout,
+    so that renderings only depend on the decoration code
+    */
+    class MockBridge: public KDecoration2::DecorationBridge
+    {
+
+        Q_OBJECT
+
+        public:
+
+        //* constructor
+        explicit MockBridge( QObject* parent = nullptr );
+
+        //* destructor
+        ~MockBridge() override;
+
+        //* initialized decoration for a window in given state
+        std::unique_ptr<Decoration> createDecoration( const MockWindow& = MockWindow() );
+
+        //*@name bridge
+        //@{
+
+        std::unique_ptr<KDecoration2::DecoratedClientPrivate> createClient( KDecoration2::DecoratedClient*, KDecoration2::Decoration* ) override;
+        std::unique_ptr<KDecoration2::DecorationSettingsPrivate> settings( KDecoration2::DecorationSettings* ) override;
+        void update( KDecoration2::Decoration*, const QRect& ) override
+        {}
+
+        //@}
+
+        private:
+
+        //* state of the window next client is created for
+        MockWindow m_window;
+
+        //* settings shared by all decorations
+        std::shared_ptr<KDecoration2::DecorationSettings> m_settings;
+
+    };
+
+}
+
+#endif
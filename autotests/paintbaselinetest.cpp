@@ -0,0 +1,276 @@
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breezebutton.h"
+#include "breezedecoration.h"
+#include "breezepaintverifier.h"
+#include "mockbridge.h"
+
+#include <QDir>
+#include <QStandardPaths>
+#include <QTest>
+
+#include <memory>
+
+using namespace SierraBreeze;
+
+//* decoration and button renderings, through the reference and optimized paths, against the committed baselines
+/**
+baselines live in autotests/baselines, one png per rendering. Set SIERRABREEZE_UPDATE_BASELINES
+to write the reference renderings there instead of comparing, after an intended change of the rendering.
+Renderings that do not match are saved in the working directory
+*/
+class PaintBaselineTest: public QObject
+{
+
+    Q_OBJECT
+
+    private Q_SLOTS:
+
+    void initTestCase();
+
+    void decoration_data();
+    void decoration();
+
+    void button_data();
+    void button();
+
+    private:
+
+    //* paint, through both paths, and compare to baseline of given name
+    void check( const QString& name, const QSize&, qreal devicePixelRatio, const PaintVerifier::PaintFunction& );
+
+    //* bridge
+    std::unique_ptr<MockBridge> m_bridge;
+
+};
+
+namespace
+{
+
+    //* button types
+    struct ButtonType
+    {
+        KDecoration2::DecorationButtonType type;
+        const char* name;
+    };
+
+    const ButtonType buttonTypes[] = {
+        { KDecoration2::DecorationButtonType::Menu, "menu" },
+        { KDecoration2::DecorationButtonType::ApplicationMenu, "applicationmenu" },
+        { KDecoration2::DecorationButtonType::OnAllDesktops, "onalldesktops" },
+        { KDecoration2::DecorationButtonType::Minimize, "minimize" },
+        { KDecoration2::DecorationButtonType::Maximize, "maximize" },
+        { KDecoration2::DecorationButtonType::Close, "close" },
+        { KDecoration2::DecorationButtonType::ContextHelp, "contexthelp" },
+        { KDecoration2::DecorationButtonType::Shade, "shade" },
+        { KDecoration2::DecorationButtonType::KeepBelow, "keepbelow" },
+        { KDecoration2::DecorationButtonType::KeepAbove, "keepabove" } };
+
+    //* button interaction states
+    struct ButtonState
+    {
+        const char* name;
+        bool hovered;
+        bool pressed;
+        bool checked;
+    };
+
+    const ButtonState buttonStates[] = {
+        { "normal", false, false, false },
+        { "hovered", true, false, false },
+        { "pressed", true, true, false },
+        { "checked", false, false, true },
+        { "checked-hovered", true, false, true } };
+
+    //* device pixel ratios
+    const qreal devicePixelRatios[] = { 1, 2 };
+
+    //* suffix of baseline names for a device pixel ratio
+    QString scaleSuffix( qreal devicePixelRatio )
+    { return QStringLiteral( "@%1x" ).arg( devicePixelRatio ); }
+
+}
+
+//__________________________________________________________________
+void PaintBaselineTest::initTestCase()
+{
+    // keep the user configuration out of the renderings
+    QStandardPaths::setTestModeEnabled( true );
+    m_bridge = std::make_unique<MockBridge>();
+}
+
+//__________________________________________________________________
+void PaintBaselineTest::decoration_data()
+{
+
+    QTest::addColumn<bool>( "active" );
+    QTest::addColumn<bool>( "maximized" );
+    QTest::addColumn<qreal>( "devicePixelRatio" );
+
+    for( const qreal devicePixelRatio : devicePixelRatios )
+    {
+        const QString suffix( scaleSuffix( devicePixelRatio ) );
+        QTest::newRow( qPrintable( QStringLiteral( "decoration-active" ) + suffix ) ) << true << false << devicePixelRatio;
+        QTest::newRow( qPrintable( QStringLiteral( "decoration-inactive" ) + suffix ) ) << false << false << devicePixelRatio;
+        QTest::newRow( qPrintable( QStringLiteral( "decoration-maximized" ) + suffix ) ) << true << true << devicePixelRatio;
+    }
+
+}
+
+//__________________________________________________________________
+void PaintBaselineTest::decoration()
+{
+
+    QFETCH( bool, active );
+    QFETCH( bool, maximized );
+    QFETCH( qreal, devicePixelRatio );
+
+    MockWindow window;
+    window.active = active;
+    window.maximized = maximized;
+    const std::unique_ptr<Decoration> decoration( m_bridge->createDecoration( window ) );
+
+    // let the buttons be laid out
+    QCoreApplication::processEvents();
+
+    const QRect rect( QPoint( 0, 0 ), decoration->size() );
+    check( QString::fromLatin1( QTest::currentDataTag() ), rect.size(), devicePixelRatio,
+        [&decoration, &rect]( QPainter* painter ) { decoration->paint( painter, rect ); } );
+
+}
+
+//__________________________________________________________________
+void PaintBaselineTest::button_data()
+{
+
+    QTest::addColumn<int>( "type" );
+    QTest::addColumn<bool>( "active" );
+    QTest::addColumn<bool>( "hovered" );
+    QTest::addColumn<bool>( "pressed" );
+    QTest::addColumn<bool>( "checked" );
+    QTest::addColumn<qreal>( "devicePixelRatio" );
+
+    for( const ButtonType& type : buttonTypes )
+    {
+        for( const ButtonState& state : buttonStates )
+        {
+            for( const bool active : { true, false } )
+            {
+                for( const qreal devicePixelRatio : devicePixelRatios )
+                {
+                    const QString name( QStringLiteral( "button-%1-%2-%3%4" )
+                        .arg( QLatin1String( type.name ), QLatin1String( state.name ),
+                            active ? QStringLiteral( "active" ) : QStringLiteral( "inactive" ),
+                            scaleSuffix( devicePixelRatio ) ) );
+
+                    QTest::newRow( qPrintable( name ) ) << int( type.type ) << active
+                        << state.hovered << state.pressed << state.checked << devicePixelRatio;
+                }
+            }
+        }
+    }
+
+}
+
+//__________________________________________________________________
+void PaintBaselineTest::button()
+{
+
+    QFETCH( int, type );
+    QFETCH( bool, active );
+    QFETCH( bool, hovered );
+    QFETCH( bool, pressed );
+    QFETCH( bool, checked );
+    QFETCH( qreal, devicePixelRatio );
+
+    MockWindow window;
+    window.active = active;
+    const std::unique_ptr<Decoration> decoration( m_bridge->createDecoration( window ) );
+    QCoreApplication::processEvents();
+
+    // the button is released away from itself, if at all, so that it is never clicked
+    std::unique_ptr<Button> button( Button::create( KDecoration2::DecorationButtonType( type ), decoration.get(), nullptr ) );
+    QVERIFY( button );
+
+    button->setVisible( true );
+    if( checked )
+    {
+        button->setCheckable( true );
+        button->setChecked( true );
+    }
+
+    button->setInteractionState( hovered, pressed );
+
+    const QRect rect( button->geometry().toAlignedRect() );
+    check( QString::fromLatin1( QTest::currentDataTag() ), rect.size() + QSize( rect.x(), rect.y() ), devicePixelRatio,
+        [&button, &rect]( QPainter* painter ) { button->paint( painter, rect ); } );
+
+    button->setInteractionState( false, false );
+
+}
+
+//__________________________________________________________________
+void PaintBaselineTest::check( const QString& name, const QSize& size, qreal devicePixelRatio, const PaintVerifier::PaintFunction& function )
+{
+
+    QVERIFY( !size.isEmpty() );
+
+    // button sprites are cold on the first optimized pass, and warm on the second
+    Button::clearSpriteCache();
+    const QImage reference( PaintVerifier::render( size, devicePixelRatio, function, true ) );
+    const QImage cold( PaintVerifier::render( size, devicePixelRatio, function, false ) );
+    const QImage warm( PaintVerifier::render( size, devicePixelRatio, function, false ) );
+
+    const QString path( QStringLiteral( SIERRABREEZE_BASELINE_DIR "/%1.png" ).arg( name ) );
+    if( qEnvironmentVariableIsSet( "SIERRABREEZE_UPDATE_BASELINES" ) )
+    {
+        QVERIFY( QDir().mkpath( QStringLiteral( SIERRABREEZE_BASELINE_DIR ) ) );
+        QVERIFY( reference.save( path ) );
+    }
+
+    const QImage baseline( path );
+    if( baseline.isNull() )
+    {
+        reference.save( QStringLiteral( "%1.png" ).arg( name ) );
+        QFAIL( qPrintable( QStringLiteral( "no baseline %1. Run with SIERRABREEZE_UPDATE_BASELINES set to create it" ).arg( path ) ) );
+    }
+
+    const int tolerance( PaintVerifier::tolerance() );
+    const struct { const char* pass; const QImage& image; } passes[] = {
+        { "reference", reference },
+        { "optimized", cold },
+        { "optimized with warm caches", warm } };
+
+    for( const auto& pass : passes )
+    {
+        int mismatches( 0 );
+        const int difference( PaintVerifier::compare( baseline, pass.image, tolerance, &mismatches ) );
+        if( mismatches ) pass.image.save( QStringLiteral( "%1-%2.png" ).arg( name, QString::fromLatin1( pass.pass ).replace( QLatin1Char( ' ' ), QLatin1Char( '-' ) ) ) );
+
+        QVERIFY2( !mismatches, qPrintable( QStringLiteral( "%1 rendering differs from baseline: %2 pixels, max channel difference %3" )
+            .arg( QLatin1String( pass.pass ) ).arg( mismatches ).arg( difference ) ) );
+    }
+
+}
+
+QTEST_MAIN( PaintBaselineTest )
+
+#include "paintbaselinetest.moc"
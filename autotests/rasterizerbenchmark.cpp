@@ -0,0 +1,226 @@
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breezerasterizer.h"
+
+#include <QPainter>
+#include <QTest>
+
+#include <cmath>
+
+using namespace SierraBreeze;
+
+//* rasterizer primitives against the QPainter code they replace, for speed and for output
+class RasterizerBenchmark: public QObject
+{
+
+    Q_OBJECT
+
+    private Q_SLOTS:
+
+    void fillCircle_data();
+    void fillCircle();
+
+    void crossfade_data();
+    void crossfade();
+
+    void compareCircle_data();
+    void compareCircle();
+
+    void compareCrossfade();
+
+    private:
+
+    //* transparent image of given size
+    static QImage image( const QSize& size )
+    {
+        QImage out( size, QImage::Format_ARGB32_Premultiplied );
+        out.fill( Qt::transparent );
+        return out;
+    }
+
+    //* circle, painted with QPainter
+    static void paintCircle( QImage& image, const QPointF& center, qreal radius, const QColor& color )
+    {
+        QPainter painter( &image );
+        painter.setRenderHint( QPainter::Antialiasing );
+        painter.setPen( Qt::NoPen );
+        painter.setBrush( color );
+        painter.drawEllipse( center, radius, radius );
+    }
+
+    //* crossfade of opaque images, painted with QPainter
+    static void paintCrossfade( QImage& target, const QImage& from, const QImage& to, qreal ratio )
+    {
+        QPainter painter( &target );
+        painter.setCompositionMode( QPainter::CompositionMode_Source );
+        painter.drawImage( 0, 0, from );
+        painter.setCompositionMode( QPainter::CompositionMode_SourceOver );
+        painter.setOpacity( ratio );
+        painter.drawImage( 0, 0, to );
+    }
+
+    //* opaque titlebar-like image: vertical gradient and a few button-like circles
+    static QImage titleBar( const QColor& color )
+    {
+        QImage out( QSize( 1200, 32 ), QImage::Format_ARGB32_Premultiplied );
+        QLinearGradient gradient( 0, 0, 0, out.height() );
+        gradient.setColorAt( 0.0, color.lighter( 120 ) );
+        gradient.setColorAt( 0.8, color );
+
+        QPainter painter( &out );
+        painter.fillRect( out.rect(), gradient );
+        painter.setRenderHint( QPainter::Antialiasing );
+        painter.setPen( Qt::NoPen );
+        painter.setBrush( color.lightness() > 128 ? Qt::black : Qt::white );
+        for( int i = 0; i < 3; ++i ) painter.drawEllipse( QPointF( 16 + 24*i, 16 ), 9, 9 );
+        return out;
+    }
+
+    //* max per-channel difference between two images of the same size. Number of pixels above tolerance is stored in the last argument
+    static int compare( const QImage& first, const QImage& second, int tolerance, int* mismatches )
+    {
+        *mismatches = 0;
+        int out( 0 );
+        for( int y = 0; y < first.height(); ++y )
+        {
+            const QRgb* a( reinterpret_cast<const QRgb*>( first.constScanLine( y ) ) );
+            const QRgb* b( reinterpret_cast<const QRgb*>( second.constScanLine( y ) ) );
+            for( int x = 0; x < first.width(); ++x )
+            {
+                const int difference( qMax(
+                    qMax( qAbs( qRed( a[x] ) - qRed( b[x] ) ), qAbs( qGreen( a[x] ) - qGreen( b[x] ) ) ),
+                    qMax( qAbs( qBlue( a[x] ) - qBlue( b[x] ) ), qAbs( qAlpha( a[x] ) - qAlpha( b[x] ) ) ) ) );
+
+                out = qMax( out, difference );
+                if( difference > tolerance ) ++*mismatches;
+            }
+        }
+
+        return out;
+    }
+
+};
+
+//__________________________________________________________________
+void RasterizerBenchmark::fillCircle_data()
+{
+    QTest::addColumn<bool>( "rasterizer" );
+    QTest::addColumn<qreal>( "radius" );
+
+    // button backgrounds at scales 1, 2 and 3
+    for( const qreal radius : { 9.0, 18.0, 27.0 } )
+    {
+        QTest::addRow( "rasterizer %g", radius ) << true << radius;
+        QTest::addRow( "qpainter %g", radius ) << false << radius;
+    }
+}
+
+//__________________________________________________________________
+void RasterizerBenchmark::fillCircle()
+{
+    QFETCH( bool, rasterizer );
+    QFETCH( qreal, radius );
+
+    const int size( std::ceil( 2*radius ) + 2 );
+    QImage target( image( QSize( size, size ) ) );
+    const QPointF center( 1.3 + radius, 1.3 + radius );
+    const QColor color( 255, 92, 87 );
+
+    if( rasterizer ) { QBENCHMARK { Rasterizer::fillCircle( target, center, radius, color ); } }
+    else { QBENCHMARK { paintCircle( target, center, radius, color ); } }
+}
+
+//__________________________________________________________________
+void RasterizerBenchmark::crossfade_data()
+{
+    QTest::addColumn<bool>( "rasterizer" );
+    QTest::newRow( "rasterizer" ) << true;
+    QTest::newRow( "qpainter" ) << false;
+}
+
+//__________________________________________________________________
+void RasterizerBenchmark::crossfade()
+{
+    QFETCH( bool, rasterizer );
+
+    const QImage from( titleBar( QColor( 70, 70, 70 ) ) );
+    const QImage to( titleBar( QColor( 220, 220, 220 ) ) );
+    QImage target( image( from.size() ) );
+
+    if( rasterizer ) { QBENCHMARK { Rasterizer::crossfade( target, from, to, 0.4 ); } }
+    else { QBENCHMARK { paintCrossfade( target, from, to, 0.4 ); } }
+}
+
+//__________________________________________________________________
+void RasterizerBenchmark::compareCircle_data()
+{
+    QTest::addColumn<qreal>( "radius" );
+    QTest::addColumn<QPointF>( "center" );
+
+    QTest::newRow( "aligned" ) << 9.0 << QPointF( 10, 10 );
+    QTest::newRow( "subpixel" ) << 9.0 << QPointF( 10.3, 10.7 );
+    QTest::newRow( "fractional scale" ) << 11.25 << QPointF( 12.5, 12.5 );
+    QTest::newRow( "large" ) << 27.0 << QPointF( 28.4, 28.4 );
+}
+
+//__________________________________________________________________
+void RasterizerBenchmark::compareCircle()
+{
+    QFETCH( qreal, radius );
+    QFETCH( QPointF, center );
+
+    const int size( std::ceil( 2*radius ) + 4 );
+    QImage reference( image( QSize( size, size ) ) );
+    QImage rasterized( image( QSize( size, size ) ) );
+    paintCircle( reference, center, radius, Qt::black );
+    Rasterizer::fillCircle( rasterized, center, radius, Qt::black );
+
+    /*
+    coverage is derived from the distance to the edge, linearly, where QPainter computes the covered area.
+    Both agree inside and outside the circle, and on edge pixels to within 13 levels, on edges at 45 degrees
+    */
+    int mismatches( 0 );
+    const int difference( compare( reference, rasterized, 16, &mismatches ) );
+    QVERIFY2( !mismatches, qPrintable( QStringLiteral( "%1 pixels differ, max channel difference %2" ).arg( mismatches ).arg( difference ) ) );
+}
+
+//__________________________________________________________________
+void RasterizerBenchmark::compareCrossfade()
+{
+    const QImage from( titleBar( QColor( 70, 70, 70 ) ) );
+    const QImage to( titleBar( QColor( 220, 220, 220 ) ) );
+
+    for( const qreal ratio : { 0.0, 0.25, 0.5, 0.75, 1.0 } )
+    {
+        QImage reference( image( from.size() ) );
+        QImage rasterized( image( from.size() ) );
+        paintCrossfade( reference, from, to, ratio );
+        Rasterizer::crossfade( rasterized, from, to, ratio );
+
+        int mismatches( 0 );
+        const int difference( compare( reference, rasterized, 2, &mismatches ) );
+        QVERIFY2( !mismatches, qPrintable( QStringLiteral( "ratio %1: %2 pixels differ, max channel difference %3" ).arg( ratio ).arg( mismatches ).arg( difference ) ) );
+    }
+}
+
+QTEST_GUILESS_MAIN( RasterizerBenchmark )
+
+#include "rasterizerbenchmark.moc"
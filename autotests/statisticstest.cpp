@@ -0,0 +1,242 @@
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breezedecoration.h"
+#include "mockbridge.h"
+
+#include <QDBusArgument>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QDBusPendingCall>
+#include <QDBusVariant>
+#include <QImage>
+#include <QPainter>
+#include <QStandardPaths>
+#include <QTest>
+
+#include <memory>
+
+using namespace SierraBreeze;
+
+//* performance counters, as read over the session bus
+/**
+runs under dbus-run-session. Counters are read from a second connection, as qdbus would,
+so that calls go through the bus daemon and the exported interface
+*/
+class StatisticsTest: public QObject
+{
+
+    Q_OBJECT
+
+    private Q_SLOTS:
+
+    void initTestCase();
+    void cleanupTestCase();
+
+    void properties();
+    void cacheHitRatios();
+    void windowStatistics();
+    void reset();
+    void unregister();
+
+    private:
+
+    //* call a method of the statistics object, and wait for the reply
+    QDBusMessage call( const QString& interface, const QString& method, const QVariantList& arguments = QVariantList() ) const;
+
+    //* all properties of the statistics interface
+    QVariantMap properties( void ) const;
+
+    //* map returned by a method of the statistics interface
+    QVariantMap map( const QString& method ) const;
+
+    //* bridge
+    std::unique_ptr<MockBridge> m_bridge;
+
+    //* decoration, for the statistics object to exist
+    std::unique_ptr<Decoration> m_decoration;
+
+    //* connection the counters are read from
+    std::unique_ptr<QDBusConnection> m_client;
+
+};
+
+namespace
+{
+    const QString statisticsPath( QStringLiteral( "/SierraBreeze/Stats" ) );
+    const QString statisticsInterface( QStringLiteral( "org.kde.SierraBreeze.Stats" ) );
+    const QString propertiesInterface( QStringLiteral( "org.freedesktop.DBus.Properties" ) );
+}
+
+//__________________________________________________________________
+void StatisticsTest::initTestCase()
+{
+
+    QVERIFY2( QDBusConnection::sessionBus().isConnected(), "no session bus, run the test under dbus-run-session" );
+
+    m_client = std::make_unique<QDBusConnection>( QDBusConnection::connectToBus( QDBusConnection::SessionBus, QStringLiteral( "statisticstest" ) ) );
+    QVERIFY( m_client->isConnected() );
+
+    QStandardPaths::setTestModeEnabled( true );
+    m_bridge = std::make_unique<MockBridge>();
+    m_decoration = m_bridge->createDecoration();
+    QCoreApplication::processEvents();
+
+    // paint twice, so that caches are both missed and hit
+    const QRect rect( QPoint( 0, 0 ), m_decoration->size() );
+    QImage image( rect.size(), QImage::Format_ARGB32_Premultiplied );
+    QPainter painter( &image );
+    m_decoration->paint( &painter, rect );
+    m_decoration->paint( &painter, rect );
+
+}
+
+//__________________________________________________________________
+void StatisticsTest::cleanupTestCase()
+{
+    m_decoration.reset();
+    QDBusConnection::disconnectFromBus( QStringLiteral( "statisticstest" ) );
+}
+
+//__________________________________________________________________
+void StatisticsTest::properties()
+{
+
+    const QVariantMap properties( this->properties() );
+    const QStringList names = {
+        QStringLiteral( "paintsPerSecond" ),
+        QStringLiteral( "averagePaintTime" ),
+        QStringLiteral( "maxPaintTime" ),
+        QStringLiteral( "paints" ),
+        QStringLiteral( "shadowRegenerations" ),
+        QStringLiteral( "blurRegionRebuilds" ),
+        QStringLiteral( "exceptionMatches" ),
+        QStringLiteral( "exceptionMatchTime" ),
+        QStringLiteral( "decorationCount" ) };
+
+    for( const QString& name : names )
+    { QVERIFY2( properties.contains( name ), qPrintable( name ) ); }
+
+    QCOMPARE( properties.value( QStringLiteral( "decorationCount" ) ).toInt(), 1 );
+    QVERIFY( properties.value( QStringLiteral( "paints" ) ).toLongLong() >= 2 );
+    QVERIFY( properties.value( QStringLiteral( "averagePaintTime" ) ).toDouble() > 0 );
+
+    // a single property, as qdbus reads it
+    const QDBusMessage reply( call( propertiesInterface, QStringLiteral( "Get" ), { statisticsInterface, QStringLiteral( "paints" ) } ) );
+    QCOMPARE( reply.type(), QDBusMessage::ReplyMessage );
+    QCOMPARE( reply.arguments().value( 0 ).value<QDBusVariant>().variant().toLongLong(), properties.value( QStringLiteral( "paints" ) ).toLongLong() );
+
+}
+
+//__________________________________________________________________
+void StatisticsTest::cacheHitRatios()
+{
+
+    const QVariantMap ratios( map( QStringLiteral( "cacheHitRatios" ) ) );
+    QCOMPARE( ratios.keys(), QStringList( { QStringLiteral( "buttonSprite" ), QStringLiteral( "shadow" ) } ) );
+
+    for( const QVariant& ratio : ratios )
+    {
+        QVERIFY( ratio.toDouble() >= 0 );
+        QVERIFY( ratio.toDouble() <= 1 );
+    }
+
+}
+
+//__________________________________________________________________
+void StatisticsTest::windowStatistics()
+{
+
+    const QVariantMap windows( map( QStringLiteral( "windowStatistics" ) ) );
+    QCOMPARE( windows.size(), 1 );
+
+    // mock clients have no window id
+    QVERIFY( windows.firstKey().startsWith( QLatin1String( "decoration-0x" ) ) );
+
+    const QVariantMap window( qdbus_cast<QVariantMap>( windows.first() ) );
+    QVERIFY( window.value( QStringLiteral( "paints" ) ).toLongLong() >= 2 );
+
+}
+
+//__________________________________________________________________
+void StatisticsTest::reset()
+{
+
+    QCOMPARE( call( statisticsInterface, QStringLiteral( "reset" ) ).type(), QDBusMessage::ReplyMessage );
+
+    // counters are cleared, decorations are kept
+    const QVariantMap properties( this->properties() );
+    for( auto iter = properties.cbegin(); iter != properties.cend(); ++iter )
+    {
+        if( iter.key() == QLatin1String( "decorationCount" ) ) QCOMPARE( iter.value().toInt(), 1 );
+        else QVERIFY2( iter.value().toDouble() == 0, qPrintable( iter.key() ) );
+    }
+
+    const QVariantMap ratios( map( QStringLiteral( "cacheHitRatios" ) ) );
+    for( auto iter = ratios.cbegin(); iter != ratios.cend(); ++iter )
+    { QVERIFY2( iter.value().toDouble() == 0, qPrintable( iter.key() ) ); }
+
+    const QVariantMap windows( map( QStringLiteral( "windowStatistics" ) ) );
+    QCOMPARE( windows.size(), 1 );
+    QCOMPARE( qdbus_cast<QVariantMap>( windows.first() ).value( QStringLiteral( "paints" ) ).toLongLong(), 0 );
+
+}
+
+//__________________________________________________________________
+void StatisticsTest::unregister()
+{
+
+    // the object leaves the bus with the last decoration
+    m_decoration.reset();
+    QCOMPARE( call( propertiesInterface, QStringLiteral( "GetAll" ), { statisticsInterface } ).type(), QDBusMessage::ErrorMessage );
+
+}
+
+//__________________________________________________________________
+QDBusMessage StatisticsTest::call( const QString& interface, const QString& method, const QVariantList& arguments ) const
+{
+
+    QDBusMessage message( QDBusMessage::createMethodCall( QDBusConnection::sessionBus().baseService(), statisticsPath, interface, method ) );
+    message.setArguments( arguments );
+
+    // the object lives in this thread, so the event loop must run for the call to be served
+    QDBusPendingCall pending( m_client->asyncCall( message ) );
+    QTest::qWaitFor( [&pending]() { return pending.isFinished(); }, 5000 );
+    return pending.reply();
+
+}
+
+//__________________________________________________________________
+QVariantMap StatisticsTest::properties( void ) const
+{
+    const QDBusMessage reply( call( propertiesInterface, QStringLiteral( "GetAll" ), { statisticsInterface } ) );
+    return reply.type() == QDBusMessage::ReplyMessage ? qdbus_cast<QVariantMap>( reply.arguments().value( 0 ) ) : QVariantMap();
+}
+
+//__________________________________________________________________
+QVariantMap StatisticsTest::map( const QString& method ) const
+{
+    const QDBusMessage reply( call( statisticsInterface, method ) );
+    return reply.type() == QDBusMessage::ReplyMessage ? qdbus_cast<QVariantMap>( reply.arguments().value( 0 ) ) : QVariantMap();
+}
+
+QTEST_MAIN( StatisticsTest )
+
+#include "statisticstest.moc"
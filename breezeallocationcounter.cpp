@@ -0,0 +1,146 @@
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breezeallocationcounter.h"
+
+#include <QDebug>
+
+#include <dlfcn.h>
+#include <limits>
+
+namespace SierraBreeze
+{
+
+    namespace
+    {
+
+        //* counter exported by the preloaded hooks
+        using CountFunction = unsigned long long (*)();
+
+        //* resolve counter once
+        CountFunction countFunction()
+        {
+            static const CountFunction function = reinterpret_cast<CountFunction>( dlsym( RTLD_DEFAULT, "sierrabreeze_allocation_count" ) );
+            return function;
+        }
+
+        //* accumulated statistics for one section
+        struct SectionStatistics
+        {
+            quint64 calls = 0;
+            quint64 allocations = 0;
+            quint64 min = std::numeric_limits<quint64>::max();
+            quint64 max = 0;
+        };
+
+        //* all sections. Decorations are painted from kwin's main thread only
+        SectionStatistics s_statistics[ AllocationCounter::SectionCount ];
+
+        //* section names, for reporting
+        const char* const s_sectionNames[ AllocationCounter::SectionCount ] =
+        {
+            "Decoration::paint",
+            "Button::paint",
+            "Decoration::updateBlur",
+            "Decoration::updateButtonsGeometry"
+        };
+
+        //* number of decoration paints between two reports
+        const quint64 s_reportInterval = 1000;
+
+    }
+
+    //__________________________________________________________________
+    AllocationCounter::Scope::Scope( Section section ):
+        m_section( section ),
+        m_start( AllocationCounter::count() )
+    {}
+
+    //__________________________________________________________________
+    AllocationCounter::Scope::~Scope()
+    { AllocationCounter::record( m_section, AllocationCounter::count() - m_start ); }
+
+    //__________________________________________________________________
+    quint64 AllocationCounter::count( void )
+    {
+        const auto function = countFunction();
+        return function ? function() : 0;
+    }
+
+    //__________________________________________________________________
+    bool AllocationCounter::isAvailable( void )
+    { return countFunction() != nullptr; }
+
+    //__________________________________________________________________
+    void AllocationCounter::record( Section section, quint64 allocations )
+    {
+        auto& statistics( s_statistics[section] );
+        ++statistics.calls;
+        statistics.allocations += allocations;
+        statistics.min = qMin( statistics.min, allocations );
+        statistics.max = qMax( statistics.max, allocations );
+
+        if( section == DecorationPaint && statistics.calls >= s_reportInterval )
+        { report(); }
+    }
+
+    //__________________________________________________________________
+    void AllocationCounter::report( void )
+    {
+
+        const bool available( isAvailable() );
+        static bool warned( false );
+        if( !available && !warned )
+        {
+            qWarning() << "SierraBreeze: allocation counting enabled but libsierrabreeze_allocationhooks is not preloaded";
+            warned = true;
+        }
+
+        for( int section = 0; section < SectionCount; ++section )
+        {
+            auto& statistics( s_statistics[section] );
+            if( !statistics.calls || !available )
+            {
+                statistics = SectionStatistics();
+                continue;
+            }
+
+            qDebug().nospace() << "SierraBreeze: " << s_sectionNames[section]
+                << " calls: " << statistics.calls
+                << " allocations/call: " << double( statistics.allocations )/statistics.calls
+                << " min: " << statistics.min
+                << " max: " << statistics.max;
+
+            /*
+            the cheapest repaint over the interval is the steady state one: nothing changed since
+            the previous frame and every cache is warm. It is expected to be allocation free.
+            */
+            if( ( section == DecorationPaint || section == ButtonPaint ) && statistics.min > 0 )
+            {
+                qWarning().nospace() << "SierraBreeze: steady-state " << s_sectionNames[section]
+                    << " performs " << statistics.min << " allocations, target is zero";
+            }
+
+            statistics = SectionStatistics();
+        }
+
+    }
+
+}
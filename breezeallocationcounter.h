@@ -0,0 +1,102 @@
+#ifndef breezeallocationcounter_h
+#define breezeallocationcounter_h
+
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config-breeze.h"
+
+#if SIERRABREEZE_ALLOCATION_COUNTING
+
+#include <QtGlobal>
+
+namespace SierraBreeze
+{
+
+    //* heap allocation accounting for the paint path
+    /**
+    counts are read from libsierrabreeze_allocationhooks, which must be preloaded in kwin.
+    Scopes are inclusive: a Button::paint scope is also accounted in the enclosing Decoration::paint.
+    */
+    class AllocationCounter
+    {
+
+        public:
+
+        //* instrumented sections
+        enum Section
+        {
+            DecorationPaint,
+            ButtonPaint,
+            UpdateBlur,
+            UpdateButtonsGeometry,
+            SectionCount
+        };
+
+        //* scoped counter
+        class Scope
+        {
+            public:
+
+            //* constructor
+            explicit Scope( Section );
+
+            //* destructor
+            ~Scope();
+
+            private:
+
+            Q_DISABLE_COPY( Scope )
+
+            //* section
+            Section m_section;
+
+            //* allocation count at scope entry
+            quint64 m_start = 0;
+
+        };
+
+        //* allocations performed so far by the calling thread
+        static quint64 count( void );
+
+        //* true if the allocation hooks are loaded
+        static bool isAvailable( void );
+
+        private:
+
+        //* account allocations for a given section
+        static void record( Section, quint64 );
+
+        //* print accumulated statistics and check the zero allocation target
+        static void report( void );
+
+    };
+
+}
+
+#define BREEZE_COUNT_ALLOCATIONS( section ) SierraBreeze::AllocationCounter::Scope allocationScope( SierraBreeze::AllocationCounter::section )
+
+#else
+
+#define BREEZE_COUNT_ALLOCATIONS( section )
+
+#endif
+
+#endif
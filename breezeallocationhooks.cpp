@@ -0,0 +1,116 @@
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * malloc interposer used by the allocation counting build.
+ *
+ * The decoration plugin is dlopen'ed by kwin, so it cannot replace the allocator itself.
+ * Run kwin with LD_PRELOAD=libsierrabreeze_allocationhooks.so so that every allocation of
+ * the process, including the ones made by Qt on behalf of the plugin, goes through here.
+ * The plugin looks up sierrabreeze_allocation_count at runtime.
+ */
+
+#include <cerrno>
+#include <cstddef>
+
+#define SIERRABREEZE_HOOK_EXPORT __attribute__((visibility("default")))
+
+extern "C"
+{
+    void *__libc_malloc( size_t );
+    void *__libc_calloc( size_t, size_t );
+    void *__libc_realloc( void*, size_t );
+    void *__libc_memalign( size_t, size_t );
+}
+
+namespace
+{
+    //* per-thread allocation count. Initial-exec so that reading it never allocates
+    __thread unsigned long long s_allocations __attribute__((tls_model("initial-exec"))) = 0;
+
+    //* true for a non zero power of two
+    inline bool isPowerOfTwo( size_t value )
+    { return value && !( value & ( value - 1 ) ); }
+}
+
+extern "C"
+{
+
+    //__________________________________________________________________
+    SIERRABREEZE_HOOK_EXPORT unsigned long long sierrabreeze_allocation_count( void )
+    { return s_allocations; }
+
+    //__________________________________________________________________
+    SIERRABREEZE_HOOK_EXPORT void *malloc( size_t size )
+    {
+        ++s_allocations;
+        return __libc_malloc( size );
+    }
+
+    //__________________________________________________________________
+    SIERRABREEZE_HOOK_EXPORT void *calloc( size_t count, size_t size )
+    {
+        ++s_allocations;
+        return __libc_calloc( count, size );
+    }
+
+    //__________________________________________________________________
+    SIERRABREEZE_HOOK_EXPORT void *realloc( void *pointer, size_t size )
+    {
+        ++s_allocations;
+        return __libc_realloc( pointer, size );
+    }
+
+    //__________________________________________________________________
+    SIERRABREEZE_HOOK_EXPORT void *memalign( size_t alignment, size_t size )
+    {
+        ++s_allocations;
+        return __libc_memalign( alignment, size );
+    }
+
+    //__________________________________________________________________
+    SIERRABREEZE_HOOK_EXPORT void *aligned_alloc( size_t alignment, size_t size )
+    {
+        // __libc_memalign rounds invalid alignments up, where aligned_alloc must fail
+        if( !isPowerOfTwo( alignment ) )
+        {
+            errno = EINVAL;
+            return nullptr;
+        }
+
+        ++s_allocations;
+        return __libc_memalign( alignment, size );
+    }
+
+    //__________________________________________________________________
+    SIERRABREEZE_HOOK_EXPORT int posix_memalign( void **pointer, size_t alignment, size_t size )
+    {
+        // the pointer is left untouched on failure
+        if( !isPowerOfTwo( alignment ) || alignment % sizeof( void* ) ) return EINVAL;
+
+        ++s_allocations;
+        void *out = __libc_memalign( alignment, size );
+        if( !out ) return ENOMEM;
+
+        *pointer = out;
+        return 0;
+    }
+
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breezeanimationgovernor.h"
+#include "breezetracing.h"
+
+namespace SierraBreeze
+{
+
+    namespace
+    {
+        //* duration of a 60Hz frame, in milliseconds
+        const qint64 s_frameDuration = 16;
+    }
+
+    //__________________________________________________________________
+    AnimationGovernor& AnimationGovernor::self( void )
+    {
+        static AnimationGovernor governor;
+        return governor;
+    }
+
+    //__________________________________________________________________
+    void AnimationGovernor::setPolicy( int maxAnimations, bool reducedMotion, int frameBudget )
+    {
+        m_maxAnimations = qMax( 1, maxAnimations );
+        m_reducedMotion = reducedMotion;
+        m_frameBudget = qMax( 1, frameBudget );
+
+        if( !m_reducedMotion ) m_degraded.invalidate();
+        m_window.invalidate();
+        m_windowCost = 0;
+    }
+
+    //__________________________________________________________________
+    bool AnimationGovernor::start( QAbstractAnimation* animation )
+    {
+
+        // direction changes of a running animation are free
+        if( animation->state() == QAbstractAnimation::Running ) return true;
+
+        if( isDegraded() || m_running.size() >= m_maxAnimations ) return false;
+
+        connect( animation, &QAbstractAnimation::stateChanged, this, &AnimationGovernor::updateAnimationState, Qt::UniqueConnection );
+        connect( animation, &QObject::destroyed, this, &AnimationGovernor::removeAnimation, Qt::UniqueConnection );
+
+        m_running.insert( animation );
+        animation->start();
+        return true;
+
+    }
+
+    //__________________________________________________________________
+    void AnimationGovernor::updateAnimationState( QAbstractAnimation::State state )
+    { if( state == QAbstractAnimation::Stopped ) m_running.remove( sender() ); }
+
+    //__________________________________________________________________
+    void AnimationGovernor::removeAnimation( QObject* object )
+    { m_running.remove( object ); }
+
+    //__________________________________________________________________
+    void AnimationGovernor::recordPaint( qint64 nanoseconds )
+    {
+
+        if( !m_window.isValid() ) m_window.start();
+        m_windowCost += nanoseconds;
+
+        const qint64 elapsed( m_window.elapsed() );
+        if( elapsed < s_window ) return;
+
+        // average paint time per frame over the window, compared to the budget
+        const bool exceeded( m_windowCost*s_frameDuration > qint64( m_frameBudget )*elapsed*1000000 );
+        m_window.restart();
+        m_windowCost = 0;
+
+        if( exceeded )
+        {
+            BREEZE_TRACE_SCOPE( "AnimationGovernor::degrade" );
+            m_degraded.start();
+            finishAll();
+        }
+
+    }
+
+    //__________________________________________________________________
+    void AnimationGovernor::finishAll( void )
+    {
+
+        // finishing an animation removes it from the running set
+        const auto running( m_running );
+        for( QObject* object : running )
+        {
+            auto animation( static_cast<QAbstractAnimation*>( object ) );
+            animation->setCurrentTime( animation->direction() == QAbstractAnimation::Forward ? animation->totalDuration() : 0 );
+        }
+
+    }
+
+}
@@ -0,0 +1,130 @@
+#ifndef breezeanimationgovernor_h
+#define breezeanimationgovernor_h
+
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QAbstractAnimation>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QSet>
+
+namespace SierraBreeze
+{
+
+    //* shared limits for decoration and button animations
+    /**
+    animations are started through the governor, which refuses them, making the transition instant,
+    when too many already run or when the paints they cause exceed the frame budget.
+    Ticks need no alignment of their own: all animations are driven by Qt's unified animation timer,
+    and the resulting updates are coalesced by kwin into the next output frame.
+    */
+    class AnimationGovernor: public QObject
+    {
+
+        Q_OBJECT
+
+        public:
+
+        //* singleton
+        static AnimationGovernor& self( void );
+
+        //* policy, from the default settings. Budget is in milliseconds of painting per 60Hz frame
+        void setPolicy( int maxAnimations, bool reducedMotion, int frameBudget );
+
+        //* start animation, or return false if the transition must be instant
+        bool start( QAbstractAnimation* );
+
+        //* true while animations are refused because the frame budget was exceeded
+        bool isDegraded( void ) const
+        { return m_degraded.isValid() && !m_degraded.hasExpired( s_cooldown ); }
+
+        //* scoped paint cost accounting, only measures while animations run
+        class PaintScope
+        {
+            public:
+
+            //* constructor
+            PaintScope( void )
+            { if( AnimationGovernor::self().isMeasuring() ) m_timer.start(); }
+
+            //* destructor
+            ~PaintScope()
+            { if( m_timer.isValid() ) AnimationGovernor::self().recordPaint( m_timer.nsecsElapsed() ); }
+
+            private:
+
+            Q_DISABLE_COPY( PaintScope )
+
+            QElapsedTimer m_timer;
+
+        };
+
+        private Q_SLOTS:
+
+        //* release stopped animations
+        void updateAnimationState( QAbstractAnimation::State );
+
+        //* release destroyed animations
+        void removeAnimation( QObject* );
+
+        private:
+
+        //* constructor
+        AnimationGovernor( void ) = default;
+
+        //* true if paint costs are accounted
+        bool isMeasuring( void ) const
+        { return m_reducedMotion && !m_running.isEmpty(); }
+
+        //* account paint cost, in nanoseconds
+        void recordPaint( qint64 );
+
+        //* jump all running animations to their end
+        void finishAll( void );
+
+        //* measurement window and cool down after degrading, in milliseconds
+        static constexpr qint64 s_window = 250;
+        static constexpr qint64 s_cooldown = 1000;
+
+        //*@name policy
+        //@{
+        int m_maxAnimations = 12;
+        bool m_reducedMotion = true;
+        int m_frameBudget = 4;
+        //@}
+
+        //* running animations
+        QSet<QObject*> m_running;
+
+        //*@name paint cost over the current window
+        //@{
+        QElapsedTimer m_window;
+        qint64 m_windowCost = 0;
+        //@}
+
+        //* set when the budget is exceeded
+        QElapsedTimer m_degraded;
+
+    };
+
+}
+
+#endif
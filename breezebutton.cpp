@@ -22,23 +22,80 @@
 
 #include "breezebutton.h"
 
+#include "breezeallocationcounter.h"
+#include "breezeanimationgovernor.h"
+#include "breezeglyphregistry.h"
+#include "breezeglyphset.h"
+#include "breezepaintverifier.h"
+#include "breezerasterizer.h"
+#include "breezerendercache.h"
+#include "breezesettingsprovider.h"
+#include "breezestatistics.h"
+#include "breezetracing.h"
+
 #include <KDecoration2/DecoratedClient>
 #include <KColorUtils>
 
+#include <QHoverEvent>
+#include <QMouseEvent>
 #include <QPainter>
 #include <QPainterPath>
 
+#include <cmath>
+
 namespace SierraBreeze
 {
 
-    using KDecoration2::ColorRole;
-    using KDecoration2::ColorGroup;
     using KDecoration2::DecorationButtonType;
 
+    namespace
+    {
+
+        //* everything a button sprite depends on
+        struct SpriteKey
+        {
+            DecorationButtonType type;
+            bool hovered;
+            bool checked;
+            QSize iconSize;
+            QColor foreground;
+            QColor background;
+            QColor button;
+
+            //* sub-pixel position of the button in device pixels
+            QPointF phase;
+
+            bool operator == ( const SpriteKey& other ) const
+            {
+                return type == other.type && hovered == other.hovered && checked == other.checked &&
+                    iconSize == other.iconSize && phase == other.phase &&
+                    foreground == other.foreground && background == other.background && button == other.button;
+            }
+        };
+
+        size_t qHash( const SpriteKey& key, size_t seed = 0 )
+        {
+            return qHashMulti( seed, int( key.type ), key.hovered, key.checked, key.iconSize.width(), key.iconSize.height(),
+                key.foreground.rgba(), key.background.rgba(), key.button.rgba(), key.phase.x(), key.phase.y() );
+        }
+
+        //* button sprites, shared by all decorations. 1MB per scale
+        RenderCache<SpriteKey> s_sprites( 1024 );
+
+        //* color of the marks shown on hover
+        const QColor s_hintColor( 41, 43, 50, 200 );
+
+        //* width of the marks shown on hover, in icon units
+        qreal hintWidth( qreal iconWidth )
+        { return 1.5*qMax( qreal( 1.0 ), 20/iconWidth ); }
+
+    }
+
 
     //__________________________________________________________________
     Button::Button(DecorationButtonType type, Decoration* decoration, QObject* parent)
         : DecorationButton(type, decoration, parent)
+        , m_decoration( decoration )
         , m_animation( new QPropertyAnimation( this ) )
     {
 
@@ -57,8 +114,15 @@ namespace SierraBreeze
         // connections
         connect(decoration->client(), SIGNAL(iconChanged(QIcon)), this, SLOT(update()));
         connect(decoration->settings().get(), &KDecoration2::DecorationSettings::reconfigured, this, &Button::reconfigure);
+        connect(SettingsProvider::self(), &SettingsProvider::settingsChanged, this, &Button::reconfigure);
         connect( this, &KDecoration2::DecorationButton::hoveredChanged, this, &Button::updateAnimationState );
 
+        // the decoration focus transition shows the button as it was when the transition started
+        connect( this, &KDecoration2::DecorationButton::hoveredChanged, decoration, &Decoration::invalidateTransition );
+        connect( this, &KDecoration2::DecorationButton::pressedChanged, decoration, &Decoration::invalidateTransition );
+        connect( this, &KDecoration2::DecorationButton::checkedChanged, decoration, &Decoration::invalidateTransition );
+        connect( this, &KDecoration2::DecorationButton::visibilityChanged, decoration, &Decoration::invalidateTransition );
+
         reconfigure();
 
     }
@@ -131,6 +195,9 @@ namespace SierraBreeze
     {
         Q_UNUSED(repaintRegion)
 
+        BREEZE_COUNT_ALLOCATIONS( ButtonPaint );
+        BREEZE_TRACE_SCOPE( "Button::paint" );
+
         if (!decoration()) return;
 
         painter->save();
@@ -151,7 +218,8 @@ namespace SierraBreeze
 
         } else {
 
-            drawIcon( painter );
+            painter->translate( geometry().topLeft() );
+            if( !drawSprite( painter ) ) drawIcon( painter );
 
         }
 
@@ -159,9 +227,161 @@ namespace SierraBreeze
 
     }
 
+    #if SIERRABREEZE_PAINT_VERIFICATION
+    //__________________________________________________________________
+    void Button::setInteractionState( bool hovered, bool pressed )
+    {
+
+        const QPointF inside( geometry().center() );
+        const QPointF outside( geometry().bottomRight() + QPointF( 1, 1 ) );
+
+        if( hovered != isHovered() )
+        {
+            QHoverEvent event( hovered ? QEvent::HoverEnter : QEvent::HoverLeave,
+                hovered ? inside : outside, hovered ? inside : outside, hovered ? outside : inside );
+            if( hovered ) hoverEnterEvent( &event );
+            else hoverLeaveEvent( &event );
+        }
+
+        // released away from the button, so that it is not clicked
+        if( pressed != isPressed() )
+        {
+            QMouseEvent event( pressed ? QEvent::MouseButtonPress : QEvent::MouseButtonRelease,
+                pressed ? inside : outside, pressed ? inside : outside,
+                Qt::LeftButton, pressed ? Qt::LeftButton : Qt::NoButton, Qt::NoModifier );
+            if( pressed ) mousePressEvent( &event );
+            else mouseReleaseEvent( &event );
+        }
+
+        m_animation->stop();
+        setOpacity( isHovered() ? 1.0 : 0.0 );
+
+    }
+    #endif
+
+    //__________________________________________________________________
+    void Button::clearSpriteCache( void )
+    { s_sprites.clear(); }
+
+    //__________________________________________________________________
+    bool Button::drawSprite( QPainter *painter ) const
+    {
+
+        // animated colors change every frame, and sprites cannot be scaled or rotated
+        if( BREEZE_REFERENCE_PAINT ) return false;
+        if( m_animation->state() == QPropertyAnimation::Running ) return false;
+        if( painter->transform().type() > QTransform::TxTranslate ) return false;
+
+        auto d = m_decoration;
+        if( !d ) return false;
+
+        /*
+        sprites are rendered at the device pixel ratio of the target, and aligned on device pixels.
+        The sub-pixel part of the button position is baked in the sprite, so that it matches direct rendering
+        */
+        const qreal devicePixelRatio( painter->device()->devicePixelRatioF() );
+        const QPointF origin( painter->deviceTransform().map( QPointF( 0, 0 ) ) );
+        const QPointF phase( origin.x() - std::floor( origin.x() ), origin.y() - std::floor( origin.y() ) );
+
+        const SpriteKey key{
+            type(), isHovered(), isChecked(), m_iconSize,
+            foregroundColor(), backgroundColor(), buttonColor(),
+            phase };
+
+        const QImage* sprite( s_sprites.find( devicePixelRatio, key ) );
+        Statistics::recordCacheAccess( Statistics::ButtonSpriteCache, sprite != nullptr );
+        if( !sprite )
+        {
+
+            const QSize size( int( std::ceil( m_iconSize.width()*devicePixelRatio ) ) + 1, int( std::ceil( m_iconSize.height()*devicePixelRatio ) ) + 1 );
+            if( size.isEmpty() ) return false;
+
+            QImage image( size, QImage::Format_ARGB32_Premultiplied );
+            image.setDevicePixelRatio( devicePixelRatio );
+            image.fill( Qt::transparent );
+
+            // circular backgrounds, centered on ( 9, 9 ) in icon coordinates
+            const bool rasterize( Rasterizer::isEnabled() && Rasterizer::supports( image ) );
+            const qreal scale( m_iconSize.width()*devicePixelRatio/20 );
+            const QPointF origin( phase + QPointF( 1, 1 )*scale );
+            if( rasterize )
+            {
+                const QPointF center( origin + QPointF( 9, 9 )*scale );
+                if( key.background.isValid() ) Rasterizer::fillCircle( image, center, 9*scale, key.background );
+                if( key.foreground.isValid() && key.button.isValid() ) Rasterizer::fillCircle( image, center, 9*scale, key.button );
+            }
+
+            // built-in marks, from their distance fields
+            GlyphRegistry::Glyph glyph( GlyphRegistry::NoGlyph );
+            if( rasterize && this->glyph( glyph ) && !GlyphRegistry::self().hasSvg( glyph ) )
+            {
+
+                if( key.foreground.isValid() )
+                { GlyphSet::self().render( image, glyph, origin, scale, hintWidth( m_iconSize.width() ), s_hintColor ); }
+
+            } else {
+
+                QPainter spritePainter( &image );
+                spritePainter.translate( phase/devicePixelRatio );
+                drawIcon( &spritePainter, !rasterize );
+                spritePainter.end();
+
+            }
+
+            sprite = s_sprites.insert( key, image );
+            if( !sprite ) return false;
+
+        }
+
+        painter->drawImage( -phase/devicePixelRatio, *sprite );
+        return true;
+
+    }
+
+    //__________________________________________________________________
+    bool Button::glyph( GlyphRegistry::Glyph& glyph ) const
+    {
+        // must match the marks drawn in drawIcon
+        switch( type() )
+        {
+            case DecorationButtonType::Close:
+            glyph = isHovered() ? GlyphRegistry::Cross : GlyphRegistry::NoGlyph;
+            return true;
+
+            case DecorationButtonType::Maximize:
+            glyph = isHovered() ? GlyphRegistry::MaximizeTriangles : GlyphRegistry::NoGlyph;
+            return true;
+
+            case DecorationButtonType::Minimize:
+            glyph = isHovered() ? GlyphRegistry::MinimizeLine : GlyphRegistry::NoGlyph;
+            return true;
+
+            case DecorationButtonType::OnAllDesktops:
+            glyph = ( isHovered() || isChecked() ) ? GlyphRegistry::CenterDot : GlyphRegistry::NoGlyph;
+            return true;
+
+            case DecorationButtonType::Shade:
+            if( isChecked() ) glyph = GlyphRegistry::ShadeDown;
+            else if( isHovered() ) glyph = GlyphRegistry::ShadeUp;
+            else glyph = GlyphRegistry::NoGlyph;
+            return true;
+
+            case DecorationButtonType::KeepBelow:
+            glyph = ( isHovered() || isChecked() ) ? GlyphRegistry::ArrowDown : GlyphRegistry::NoGlyph;
+            return true;
+
+            case DecorationButtonType::KeepAbove:
+            glyph = ( isHovered() || isChecked() ) ? GlyphRegistry::ArrowUp : GlyphRegistry::NoGlyph;
+            return true;
+
+            default: return false;
+        }
+    }
+
     //__________________________________________________________________
-    void Button::drawIcon( QPainter *painter ) const
+    void Button::drawIcon( QPainter *painter, bool withBackground ) const
     {
+        BREEZE_TRACE_SCOPE( "Button::drawIcon" );
 
         painter->setRenderHints( QPainter::Antialiasing );
 
@@ -170,23 +390,32 @@ namespace SierraBreeze
         this makes all further rendering and scaling simpler
         all further rendering is preformed inside QRect( 0, 0, 18, 18 )
         */
-        painter->translate( geometry().topLeft() );
-
         const qreal width( m_iconSize.width() );
         painter->scale( width/20, width/20 );
         painter->translate( 1, 1 );
 
         // render background
-        const QColor backgroundColor( this->backgroundColor() );
-        if( backgroundColor.isValid() )
+        const QColor foregroundColor( this->foregroundColor() );
+        if( withBackground )
         {
-            painter->setPen( Qt::NoPen );
-            painter->setBrush( backgroundColor );
-            painter->drawEllipse( QRectF( 0, 0, 18, 18 ) );
+            const QColor backgroundColor( this->backgroundColor() );
+            if( backgroundColor.isValid() )
+            {
+                painter->setPen( Qt::NoPen );
+                painter->setBrush( backgroundColor );
+                painter->drawEllipse( QRectF( 0, 0, 18, 18 ) );
+            }
+
+            const QColor buttonColor( this->buttonColor() );
+            if( foregroundColor.isValid() && buttonColor.isValid() )
+            {
+                painter->setPen( Qt::NoPen );
+                painter->setBrush( buttonColor );
+                painter->drawEllipse( QRectF( 0, 0, 18, 18 ) );
+            }
         }
 
         // render mark
-        const QColor foregroundColor( this->foregroundColor() );
         if( foregroundColor.isValid() )
         {
 
@@ -198,167 +427,37 @@ namespace SierraBreeze
 
             painter->setPen( pen );
             painter->setBrush( Qt::NoBrush );
-            auto d = qobject_cast<Decoration*>( decoration() );
-            auto c = d->client();
 
-            const auto hover_hint_color = QColor(41, 43, 50, 200);
-            QPen hint_pen(hover_hint_color);
-            hint_pen.setCapStyle( Qt::RoundCap );
-            hint_pen.setJoinStyle( Qt::MiterJoin );
-            hint_pen.setWidthF( 1.5*qMax((qreal)1.0, 20/width ) );
-
-            switch( type() )
+            // marks from the glyph registry
+            GlyphRegistry::Glyph glyph( GlyphRegistry::NoGlyph );
+            if( this->glyph( glyph ) )
             {
 
-                case DecorationButtonType::Close:
-                {
-                  QColor button_color = QColor(c->isActive() ? active_color : inactive_color);
-                  painter->setBrush( button_color );
-                  painter->setPen( Qt::NoPen );
-                  painter->drawEllipse( QRectF( 0, 0, 18, 18 ) );
-                  painter->setBrush( Qt::NoBrush );
-                  if ( isHovered() )
-                  {
-                    painter->setPen( hint_pen );
-                    // painter->setPen(pen);
-                    // it's a cross
-                    painter->drawLine( QPointF( 6, 6 ), QPointF( 12, 12 ) );
-                    painter->drawLine( QPointF( 6, 12 ), QPointF( 12, 6 ) );
-                  }
-                  painter->setPen( pen );
-
-                  break;
-                }
-
-                case DecorationButtonType::Maximize:
+                auto& registry( GlyphRegistry::self() );
+                if( registry.hasSvg( glyph ) )
                 {
-                  QColor button_color = QColor(c->isActive() ? active_color : inactive_color);
-                  painter->setBrush( button_color );
-                  painter->setPen( Qt::NoPen );
-                  // painter->drawEllipse( QRectF( 3, 3, 12, 12 ) );
-                  painter->drawEllipse( QRectF( 0, 0, 18, 18 ) );
-                  painter->setBrush( Qt::NoBrush );
-                  if ( isHovered() )
-                  {
-                    painter->setPen( hint_pen );
-                    // two triangles
-                    QPainterPath path1, path2;
-                    path1.moveTo(5, 13);
-                    path1.lineTo(11, 13);
-                    path1.lineTo(5, 7);
-
-                    path2.moveTo(13, 5);
-                    path2.lineTo(7, 5);
-                    path2.lineTo(13, 11);
-
-
-                    painter->fillPath(path1, QBrush(hover_hint_color));
-                    painter->fillPath(path2, QBrush(hover_hint_color));
-                  }
-                    break;
-                }
 
-                case DecorationButtonType::Minimize:
-                {
-                  QColor button_color = QColor(c->isActive() ? active_color : inactive_color);
-                  painter->setBrush( button_color );
-                  painter->setPen( Qt::NoPen );
-                  // painter->drawEllipse( QRectF( 3, 3, 12, 12 ) );
-                  painter->drawEllipse( QRectF( 0, 0, 18, 18 ) );
-                  painter->setBrush( Qt::NoBrush );
-                  if ( isHovered() )
+                    // rasterized at device resolution
+                    const QRectF box( 0, 0, 18, 18 );
+                    const QSize size( painter->deviceTransform().mapRect( box ).size().toSize() );
+                    if( const QImage* image = registry.svgImage( glyph, size ) )
                     {
-                      painter->setPen( hint_pen );
-                      // painter->drawLine( QPointF( 6, 9 ), QPointF( 12, 9 ) );
-                      painter->drawLine( QPointF( 5, 9 ), QPointF( 13, 9 ) );
+                        painter->setRenderHint( QPainter::SmoothPixmapTransform );
+                        painter->drawImage( box, *image );
                     }
-                    break;
-                }
-
-                case DecorationButtonType::OnAllDesktops:
-                {
-                  QColor button_color = QColor(c->isActive() ? active_color : inactive_color);
-                  painter->setBrush( button_color );
-                  painter->setPen( Qt::NoPen );
-                  painter->drawEllipse( QRectF( 0, 0, 18, 18 ) );
-                  if ( isHovered() || isChecked() )
-                  {
-                    painter->setBrush(QBrush(hover_hint_color));
-                    painter->drawEllipse( QRectF( 6, 6, 6, 6 ) );
-                  }
-                  break;
-                }
 
-                case DecorationButtonType::Shade:
-                {
-                  QColor button_color = QColor(c->isActive() ? active_color : inactive_color);
-                  painter->setBrush( button_color );
-                  painter->setPen( Qt::NoPen );
-                  painter->setBrush( button_color );
-                  painter->drawEllipse( QRectF( 0, 0, 18, 18 ) );
-                  painter->setBrush( Qt::NoBrush );
-                    if (isChecked())
-                    {
-                        painter->setPen( hint_pen );
-                        painter->drawLine( 4, 5, 14, 5 );
-                        painter->drawPolyline( QPolygonF()
-                            << QPointF( 4, 8 )
-                            << QPointF( 9, 13 )
-                            << QPointF( 14, 8 ) );
+                } else if( glyph != GlyphRegistry::NoGlyph ) {
 
-                    }
-                    else if (isHovered()) {
-                        painter->setPen( hint_pen );
-                        painter->drawLine( 4, 5, 14, 5 );
-                        painter->drawPolyline( QPolygonF()
-                            << QPointF( 4, 13 )
-                            << QPointF( 9, 8 )
-                            << QPointF( 14, 13 ) );
-                    }
-                    break;
+                    painter->fillPath( registry.path( glyph, hintWidth( width ) ), s_hintColor );
 
                 }
 
-                case DecorationButtonType::KeepBelow:
-                {
-                  QColor button_color = QColor(c->isActive() ? active_color : inactive_color);
-                  painter->setBrush( button_color );
-                  painter->setPen( Qt::NoPen );
-                  painter->setBrush( button_color );
-                  painter->drawEllipse( QRectF( 0, 0, 18, 18 ) );
-                  painter->setBrush( Qt::NoBrush );
-                  if (isChecked() || isHovered())
-                  {
-                    painter->setPen( hint_pen );
-                    QPainterPath path;
-                    path.moveTo(9, 12);
-                    path.lineTo(5, 6);
-                    path.lineTo(13, 6);
-                    painter->fillPath(path, QBrush(hover_hint_color));
-                  }
-                    break;
-
-                }
+                return;
 
-                case DecorationButtonType::KeepAbove:
-                {
-                  QColor button_color = QColor(c->isActive() ? active_color : inactive_color);
-                  painter->setBrush( button_color );
-                  painter->setPen( Qt::NoPen );
-                  painter->drawEllipse( QRectF( 0, 0, 18, 18 ) );
-                  painter->setBrush( Qt::NoBrush );
-                  if ( isHovered() || isChecked())
-                  {
-                    painter->setPen( hint_pen );
-                    QPainterPath path;
-                    path.moveTo(9, 6);
-                    path.lineTo(5, 12);
-                    path.lineTo(13, 12);
-                    painter->fillPath(path, QBrush(hover_hint_color));
-                  }
-                    break;
-                }
+            }
 
+            switch( type() )
+            {
 
                 case DecorationButtonType::ApplicationMenu:
                 {
@@ -389,10 +488,28 @@ namespace SierraBreeze
 
     }
 
+    //__________________________________________________________________
+    QColor Button::buttonColor( void ) const
+    {
+        auto d = m_decoration;
+        if( !d ) return QColor();
+
+        // application menu and context help have no colored background
+        switch( type() )
+        {
+            case DecorationButtonType::ApplicationMenu:
+            case DecorationButtonType::ContextHelp:
+            return QColor();
+
+            default:
+            return d->isActive() ? active_color : inactive_color;
+        }
+    }
+
     //__________________________________________________________________
     QColor Button::foregroundColor( void ) const
     {
-        auto d = qobject_cast<Decoration*>( decoration() );
+        auto d = m_decoration;
         if( !d ) {
 
             return QColor();
@@ -428,17 +545,16 @@ namespace SierraBreeze
     //__________________________________________________________________
     QColor Button::backgroundColor( void ) const
     {
-        auto d = qobject_cast<Decoration*>( decoration() );
+        auto d = m_decoration;
         if( !d ) {
 
             return QColor();
 
         }
 
-        auto c = d->client();
         if( isPressed() ) {
 
-            if( type() == DecorationButtonType::Close ) return c->color( ColorGroup::Warning, ColorRole::Foreground );
+            if( type() == DecorationButtonType::Close ) return d->warningColor();
             else return KColorUtils::mix( d->titleBarColor(), d->fontColor(), 0.3 );
 
         } else if( ( type() == DecorationButtonType::KeepBelow || type() == DecorationButtonType::KeepAbove ) && isChecked() ) {
@@ -452,11 +568,11 @@ namespace SierraBreeze
                 if( d->internalSettings()->outlineCloseButton() )
                 {
 
-                    return KColorUtils::mix( d->fontColor(), c->color( ColorGroup::Warning, ColorRole::Foreground ).lighter(), m_opacity );
+                    return KColorUtils::mix( d->fontColor(), d->warningColor().lighter(), m_opacity );
 
                 } else {
 
-                    QColor color( c->color( ColorGroup::Warning, ColorRole::Foreground ).lighter() );
+                    QColor color( d->warningColor().lighter() );
                     color.setAlpha( color.alpha()*m_opacity );
                     return color;
 
@@ -472,7 +588,7 @@ namespace SierraBreeze
 
         } else if( isHovered() ) {
 
-            if( type() == DecorationButtonType::Close ) return c->color( ColorGroup::Warning, ColorRole::Foreground ).lighter();
+            if( type() == DecorationButtonType::Close ) return d->warningColor().lighter();
             else return d->fontColor();
 
         } else if( type() == DecorationButtonType::Close && d->internalSettings()->outlineCloseButton() ) {
@@ -492,7 +608,7 @@ namespace SierraBreeze
     {
 
         // animation
-        auto d = qobject_cast<Decoration*>(decoration());
+        auto d = m_decoration;
         if( d )
         {
             m_animation->setDuration( d->internalSettings()->animationsDuration() );
@@ -550,11 +666,11 @@ namespace SierraBreeze
     void Button::updateAnimationState( bool hovered )
     {
 
-        auto d = qobject_cast<Decoration*>(decoration());
+        auto d = m_decoration;
         if( !(d && d->internalSettings()->animationsEnabled() ) ) return;
 
         m_animation->setDirection( hovered ? QPropertyAnimation::Forward : QPropertyAnimation::Backward );
-        if( m_animation->state() != QPropertyAnimation::Running ) m_animation->start();
+        if( !AnimationGovernor::self().start( m_animation ) ) update();
 
     }
 
@@ -24,6 +24,7 @@
 */
 #include <KDecoration2/DecorationButton>
 #include "breezedecoration.h"
+#include "breezeglyphregistry.h"
 
 #include <QHash>
 #include <QImage>
@@ -53,6 +54,9 @@ namespace SierraBreeze
         //* render
         virtual void paint(QPainter *painter, const QRect &repaintRegion) override;
 
+        //* release the button sprites shared by all decorations
+        static void clearSpriteCache( void );
+
         //* flag
         enum Flag
         {
@@ -69,6 +73,9 @@ namespace SierraBreeze
         //* standalone buttons
         bool isStandAlone() const { return m_flag == FlagStandalone; }
 
+        //* true while the hover animation runs
+        bool isAnimating() const { return m_animation->state() == QPropertyAnimation::Running; }
+
         //* offset
         void setOffset( const QPointF& value )
         { m_offset = value; }
@@ -99,6 +106,11 @@ namespace SierraBreeze
 
         //@}
 
+        #if SIERRABREEZE_PAINT_VERIFICATION
+        //* hover and press the button, with the hover animation finished, to render these states offscreen
+        void setInteractionState( bool hovered, bool pressed );
+        #endif
+
         private Q_SLOTS:
 
         //* apply configuration changes
@@ -112,17 +124,27 @@ namespace SierraBreeze
         //* private constructor
         explicit Button(KDecoration2::DecorationButtonType type, Decoration *decoration, QObject *parent = nullptr);
 
-        //* draw button icon
-        void drawIcon( QPainter *) const;
+        //* draw button icon from the sprite cache. Returns false if the icon must be drawn directly
+        bool drawSprite( QPainter *) const;
+
+        //* glyph for the current mark. Returns false if the mark is not part of the glyph registry
+        bool glyph( GlyphRegistry::Glyph& ) const;
+
+        //* draw button icon, at origin. Circular backgrounds are skipped if withBackground is false
+        void drawIcon( QPainter *, bool withBackground = true ) const;
 
         //*@name colors
         //@{
         QColor foregroundColor( void ) const;
         QColor backgroundColor( void ) const;
+        QColor buttonColor( void ) const;
         //@}
 
         Flag m_flag = FlagNone;
 
+        //* owning decoration, resolved once instead of on every color lookup
+        Decoration* m_decoration = nullptr;
+
         //* active state change animation
         QPropertyAnimation *m_animation;
 
@@ -23,7 +23,15 @@
 
 #include "breezesettingsprovider.h"
 
+#include "breezeallocationcounter.h"
+#include "breezeanimationgovernor.h"
 #include "breezebutton.h"
+#include "breezeglyphregistry.h"
+#include "breezepaintverifier.h"
+#include "breezerasterizer.h"
+#include "breezeshadowrenderer.h"
+#include "breezestatistics.h"
+#include "breezetracing.h"
 
 #include <KDecoration2/DecorationButtonGroup>
 #include <KDecoration2/DecorationShadow>
@@ -33,11 +41,17 @@
 #include <KPluginFactory>
 #include <KSharedConfig>
 
+#include <QDebug>
+#include <QGuiApplication>
+#include <QHash>
 #include <QPainter>
 #include <QTextStream>
 #include <QTimer>
 
+#include <algorithm>
 #include <cmath>
+#include <iterator>
+#include <memory>
 #include <qnamespace.h>
 
 K_PLUGIN_FACTORY_WITH_JSON(
@@ -57,26 +71,82 @@ namespace SierraBreeze
 
     //________________________________________________________________
     static int g_sDecoCount = 0;
-    static int g_shadowSize = 0;
-    static int g_shadowStrength = 0;
-    static QColor g_shadowColor = Qt::black;
-    static std::shared_ptr<KDecoration2::DecorationShadow> g_sShadow;
+
+    //* shadow parameters
+    struct ShadowKey
+    {
+        int size;
+        int strength;
+        QRgb color;
+
+        bool operator == ( const ShadowKey& other ) const
+        { return size == other.size && strength == other.strength && color == other.color; }
+    };
+
+    static size_t qHash( const ShadowKey& key, size_t seed = 0 )
+    { return qHashMulti( seed, key.size, key.strength, key.color ); }
+
+    /*
+    shadows, keyed by parameters, so that window specific settings do not evict each other.
+    Shadow geometry is expressed in logical pixels and scaled by the compositor,
+    so one entry serves all device pixel ratios.
+    */
+    static QHash<ShadowKey, std::shared_ptr<KDecoration2::DecorationShadow>> g_shadows;
+
+    //________________________________________________________________
+    static void paintFrameCorner( QPainter* painter, const QRect& block, Qt::Corner corner, int radius )
+    {
+
+        if( block.isEmpty() ) return;
+
+        const bool left( corner == Qt::TopLeftCorner || corner == Qt::BottomLeftCorner );
+        const bool top( corner == Qt::TopLeftCorner || corner == Qt::TopRightCorner );
+
+        // block, minus the column that contains the rounded corner
+        painter->drawRect( block.adjusted( left ? radius:0, 0, left ? 0:-radius, 0 ) );
+        if( !radius ) return;
+
+        // rest of the column
+        QRect column( block );
+        if( left ) column.setWidth( radius );
+        else column.setLeft( block.right() - radius + 1 );
+        painter->drawRect( column.adjusted( 0, top ? radius:0, 0, top ? 0:-radius ) );
+
+        // rounded corner, as a quarter of a disk centered on the inner corner of the patch
+        QRect ellipse( 0, 0, 2*radius, 2*radius );
+        int startAngle = 0;
+        switch( corner )
+        {
+            case Qt::TopLeftCorner: ellipse.moveTopLeft( block.topLeft() ); startAngle = 90; break;
+            case Qt::TopRightCorner: ellipse.moveTopRight( block.topRight() ); startAngle = 0; break;
+            case Qt::BottomLeftCorner: ellipse.moveBottomLeft( block.bottomLeft() ); startAngle = 180; break;
+            case Qt::BottomRightCorner: ellipse.moveBottomRight( block.bottomRight() ); startAngle = 270; break;
+        }
+
+        painter->drawPie( ellipse, startAngle*16, 90*16 );
+
+    }
 
     //________________________________________________________________
     Decoration::Decoration(QObject *parent, const QVariantList &args)
         : KDecoration2::Decoration(parent, args)
         , m_animation( new QPropertyAnimation( this ) )
+        , m_paintVariant( &Decoration::paintVariant<false, false, true> )
     {
         g_sDecoCount++;
+        Statistics::registerDecoration( this );
     }
 
     //________________________________________________________________
     Decoration::~Decoration()
     {
+        Statistics::unregisterDecoration( this );
+
         g_sDecoCount--;
         if (g_sDecoCount == 0) {
-            // last deco destroyed, clean up shadow
-            g_sShadow.reset();
+            // last deco destroyed, clean up shadows and button sprites
+            g_shadows.clear();
+            Button::clearSpriteCache();
         }
 
     }
@@ -93,15 +163,13 @@ namespace SierraBreeze
     QColor Decoration::titleBarColor() const
     {
 
-        const auto c = client();
-        if( hideTitleBar() ) return c->color( ColorGroup::Inactive, ColorRole::TitleBar );
-        else if( m_animation->state() == QAbstractAnimation::Running )
+        const auto& colors( m_colorState );
+        if( m_paintState.hideTitleBar ) return colors.titleBar[0];
+        else if( isAnimating() )
         {
-            return KColorUtils::mix(
-                c->color( ColorGroup::Inactive, ColorRole::TitleBar ),
-                c->color( ColorGroup::Active, ColorRole::TitleBar ),
-                m_opacity );
-        } else return c->color( c->isActive() ? ColorGroup::Active : ColorGroup::Inactive, ColorRole::TitleBar );
+            if( BREEZE_REFERENCE_PAINT ) return KColorUtils::mix( colors.titleBar[0], colors.titleBar[1], m_opacity );
+            else return QColor::fromRgba( colors.titleBarSteps[ColorState::step( m_opacity )] );
+        } else return colors.titleBar[isActive()];
 
     }
 
@@ -109,14 +177,14 @@ namespace SierraBreeze
     QColor Decoration::outlineColor() const
     {
 
-        auto c( client() );
-        if( !m_internalSettings->drawTitleBarSeparator() ) return QColor();
-        if( m_animation->state() == QPropertyAnimation::Running )
+        const auto& colors( m_colorState );
+        if( !colors.drawSeparator ) return QColor();
+        if( isAnimating() )
         {
-            QColor color( c->palette().color( QPalette::Highlight ) );
+            QColor color( colors.highlight );
             color.setAlpha( color.alpha()*m_opacity );
             return color;
-        } else if( c->isActive() ) return c->palette().color( QPalette::Highlight );
+        } else if( isActive() ) return colors.highlight;
         else return QColor();
     }
 
@@ -124,16 +192,66 @@ namespace SierraBreeze
     QColor Decoration::fontColor() const
     {
 
-        auto c = client();
-        if( m_animation->state() == QPropertyAnimation::Running )
+        const auto& colors( m_colorState );
+        if( isAnimating() )
         {
-            return KColorUtils::mix(
-                        c->color( ColorGroup::Inactive, ColorRole::Foreground ),
-                        c->color( ColorGroup::Active, ColorRole::Foreground ),
-                        m_opacity );
-        } else {
-                return  c->color( c->isActive() ? ColorGroup::Active : ColorGroup::Inactive, ColorRole::Foreground );
+            if( BREEZE_REFERENCE_PAINT ) return KColorUtils::mix( colors.font[0], colors.font[1], m_opacity );
+            else return QColor::fromRgba( colors.fontSteps[ColorState::step( m_opacity )] );
+        } else return colors.font[isActive()];
+    }
+
+    //________________________________________________________________
+    void Decoration::updateColorState()
+    {
+
+        const auto c = client();
+        auto& colors( m_colorState );
+
+        colors.titleBar[0] = c->color( ColorGroup::Inactive, ColorRole::TitleBar );
+        colors.titleBar[1] = c->color( ColorGroup::Active, ColorRole::TitleBar );
+        colors.font[0] = c->color( ColorGroup::Inactive, ColorRole::Foreground );
+        colors.font[1] = c->color( ColorGroup::Active, ColorRole::Foreground );
+        colors.warning = c->color( ColorGroup::Warning, ColorRole::Foreground );
+
+        const QPalette palette( c->palette() );
+        colors.highlight = palette.color( QPalette::Highlight );
+        colors.window = palette.color( QPalette::Window );
+
+        colors.drawSeparator = m_internalSettings->drawTitleBarSeparator();
+
+        // animation frames pick the closest entry instead of mixing colors
+        for( int step = 0; step <= ColorState::Steps; ++step )
+        {
+            const qreal ratio( qreal( step )/ColorState::Steps );
+            colors.titleBarSteps[step] = KColorUtils::mix( colors.titleBar[0], colors.titleBar[1], ratio ).rgba();
+            colors.fontSteps[step] = KColorUtils::mix( colors.font[0], colors.font[1], ratio ).rgba();
         }
+
+        invalidateTransition();
+        update();
+
+    }
+
+    //________________________________________________________________
+    void Decoration::invalidateTransition()
+    {
+        m_transitionSurfaces[0] = QImage();
+        m_transitionSurfaces[1] = QImage();
+        m_transitionFrame = QImage();
+    }
+
+    //________________________________________________________________
+    bool Decoration::hasAnimatedButtons() const
+    {
+        for( const auto group : { m_leftButtons, m_rightButtons } )
+        {
+            if( !group ) continue;
+            const auto buttons = group->buttons();
+            for( const QPointer<KDecoration2::DecorationButton>& button : buttons )
+            { if( button && static_cast<Button*>( button.data() )->isAnimating() ) return true; }
+        }
+
+        return false;
     }
 
     //________________________________________________________________
@@ -167,6 +285,9 @@ namespace SierraBreeze
         connect(s.get(), &KDecoration2::DecorationSettings::reconfigured, SettingsProvider::self(), &SettingsProvider::reconfigure, Qt::UniqueConnection );
         connect(s.get(), &KDecoration2::DecorationSettings::reconfigured, this, &Decoration::updateButtonsGeometryDelayed);
 
+        // settings saved by the configuration module
+        connect(SettingsProvider::self(), &SettingsProvider::settingsChanged, this, &Decoration::updateSettings);
+
         connect(c, &KDecoration2::DecoratedClient::adjacentScreenEdgesChanged, this, &Decoration::recalculateBorders);
         connect(c, &KDecoration2::DecoratedClient::maximizedHorizontallyChanged, this, &Decoration::recalculateBorders);
         connect(c, &KDecoration2::DecoratedClient::maximizedVerticallyChanged, this, &Decoration::recalculateBorders);
@@ -175,29 +296,50 @@ namespace SierraBreeze
            [this]()
            {
                 // update the caption area
+                invalidateTransition();
                 update(titleBar());
            }
        );
 
         connect(c, &KDecoration2::DecoratedClient::activeChanged, this, &Decoration::updateAnimationState);
+        connect(c, &KDecoration2::DecoratedClient::paletteChanged, this, &Decoration::updateColorState);
+        connect(c, &KDecoration2::DecoratedClient::iconChanged, this, &Decoration::invalidateTransition);
+
+        // transition surfaces are only needed while the active state changes
+        connect(m_animation, &QAbstractAnimation::finished, this, &Decoration::invalidateTransition);
         connect(c, &KDecoration2::DecoratedClient::widthChanged, this, &Decoration::updateTitleBar);
         connect(c, &KDecoration2::DecoratedClient::maximizedChanged, this, &Decoration::updateTitleBar);
-        //connect(c, &KDecoration2::DecoratedClient::maximizedChanged, this, &Decoration::setOpaque);
 
         connect(c, &KDecoration2::DecoratedClient::widthChanged, this, &Decoration::updateButtonsGeometry);
         connect(c, &KDecoration2::DecoratedClient::maximizedChanged, this, &Decoration::updateButtonsGeometry);
         connect(c, &KDecoration2::DecoratedClient::adjacentScreenEdgesChanged, this, &Decoration::updateButtonsGeometry);
         connect(c, &KDecoration2::DecoratedClient::shadedChanged, this, &Decoration::updateButtonsGeometry);
 
+        connect(s.get(), &KDecoration2::DecorationSettings::alphaChannelSupportedChanged, this, &Decoration::updatePaintState);
+
         connect(s.get(), &KDecoration2::DecorationSettings::borderSizeChanged, this, &Decoration::updateBlur);
         connect(s.get(), &KDecoration2::DecorationSettings::fontChanged, this, &Decoration::updateBlur);
         connect(s.get(), &KDecoration2::DecorationSettings::spacingChanged, this, &Decoration::updateBlur);
         connect(c, &KDecoration2::DecoratedClient::activeChanged, this, &Decoration::updateBlur);
         connect(c, &KDecoration2::DecoratedClient::sizeChanged, this, &Decoration::updateBlur);
+        connect(c, &KDecoration2::DecoratedClient::maximizedChanged, this, &Decoration::updateBlur);
+
+        // maximized windows have no shadow
+        connect(c, &KDecoration2::DecoratedClient::maximizedChanged, this, &Decoration::createShadow);
 
         createButtons();
         createShadow();
 
+        #if SIERRABREEZE_PAINT_VERIFICATION
+        // once per process is enough, the states do not depend on the window
+        static bool buttonsVerified( false );
+        if( !buttonsVerified )
+        {
+            buttonsVerified = true;
+            QTimer::singleShot( 0, this, [this]() { verifyButtons(); } );
+        }
+        #endif
+
         return true;
     }
 
@@ -222,7 +364,7 @@ namespace SierraBreeze
 
             const auto c = client();
             m_animation->setDirection( c->isActive() ? QPropertyAnimation::Forward : QPropertyAnimation::Backward );
-            if( m_animation->state() != QPropertyAnimation::Running ) m_animation->start();
+            if( !AnimationGovernor::self().start( m_animation ) ) update();
 
         } else {
 
@@ -280,11 +422,18 @@ namespace SierraBreeze
     //________________________________________________________________
     void Decoration::reconfigure()
     {
+        BREEZE_TRACE_SCOPE( "Decoration::reconfigure" );
 
         m_internalSettings = SettingsProvider::self()->internalSettings( this );
 
         setScaledCornerRadius();
 
+        // colors
+        updateColorState();
+
+        // button marks. Sprites drawn with the previous glyph set are stale
+        if( GlyphRegistry::self().setGlyphSet( m_internalSettings->glyphSet() ) ) Button::clearSpriteCache();
+
         // animation
         m_animation->setDuration( m_internalSettings->animationsDuration() );
 
@@ -298,12 +447,40 @@ namespace SierraBreeze
         createShadow();
     }
 
+    //________________________________________________________________
+    void Decoration::updateSettings( const QStringList& keys )
+    {
+
+        // shadow changes leave the window geometry alone
+        const bool shadowOnly( !keys.isEmpty() && std::all_of( keys.begin(), keys.end(),
+            []( const QString& key ) { return key.startsWith( QLatin1String( "Shadow" ) ); } ) );
+
+        if( shadowOnly )
+        {
+
+            m_internalSettings = SettingsProvider::self()->internalSettings( this );
+            createShadow();
+
+        } else {
+
+            reconfigure();
+            updateButtonsGeometryDelayed();
+
+        }
+
+    }
+
     //________________________________________________________________
     void Decoration::recalculateBorders()
     {
+        BREEZE_TRACE_SCOPE( "Decoration::recalculateBorders" );
+
         auto c = client();
         auto s = settings();
 
+        // font or spacing might have changed, elide caption again on next paint
+        m_elidedCaptionWidth = -1;
+
         // left, right and bottom borders
         const int left   = isLeftEdge() ? 0 : borderSize();
         const int right  = isRightEdge() ? 0 : borderSize();
@@ -344,11 +521,18 @@ namespace SierraBreeze
         }
 
         setResizeOnlyBorders(QMargins(extSides, 0, extSides, extBottom));
+
+        // shade, maximization and edges are all handled here
+        updatePaintState();
     }
 
     //________________________________________________________________
     void Decoration::updateBlur()
     {
+        BREEZE_COUNT_ALLOCATIONS( UpdateBlur );
+        BREEZE_TRACE_SCOPE( "Decoration::updateBlur" );
+        Statistics::recordBlurRegionRebuild( this );
+
         // NOTE: "BlurEffect::decorationBlurRegion()" will consider the intersection of
         // the blur and decoration regions. Here we need to focus on corner rounding.
 
@@ -358,6 +542,13 @@ namespace SierraBreeze
             return;
         }
 
+        // maximized windows only show the titlebar
+        if( isMaximized() )
+        {
+            setBlurRegion(QRegion(0, 0, size().width(), borderTop()));
+            return;
+        }
+
         QRegion region;
         const auto c = client();
         QSize rSize(m_scaledCornerRadius, m_scaledCornerRadius);
@@ -426,8 +617,7 @@ namespace SierraBreeze
         const QRect titleRect(QPoint(0, 0), QSize(size().width(), borderTop()));
 
         // add the titlebar
-        if (m_scaledCornerRadius == 0
-            || isMaximized()) // maximized + no border when maximized
+        if (m_scaledCornerRadius == 0)
         {
             region |= QRegion(titleRect);
         }
@@ -491,17 +681,25 @@ void Decoration::createButtons()
     //________________________________________________________________
     void Decoration::updateButtonsGeometry()
     {
+        BREEZE_COUNT_ALLOCATIONS( UpdateButtonsGeometry );
+
         const auto s = settings();
 
         // adjust button position
         const int bHeight = captionHeight() + (isTopEdge() ? s->smallSpacing()*Metrics::TitleBar_TopMargin:0);
         const int bWidth = buttonHeight();
         const int verticalOffset = (isTopEdge() ? s->smallSpacing()*Metrics::TitleBar_TopMargin:0) + (captionHeight()-buttonHeight())/2;
-        foreach( const QPointer<KDecoration2::DecorationButton>& button, m_leftButtons->buttons() + m_rightButtons->buttons() )
+
+        // iterate over both groups in place rather than over a concatenated copy
+        for( const auto group : { m_leftButtons, m_rightButtons } )
         {
-            button.data()->setGeometry( QRectF( QPoint( 0, 0 ), QSizeF( bWidth, bHeight ) ) );
-            static_cast<Button*>( button.data() )->setOffset( QPointF( 0, verticalOffset ) );
-            static_cast<Button*>( button.data() )->setIconSize( QSize( bWidth, bWidth ) );
+            const auto buttons = group->buttons();
+            for( const QPointer<KDecoration2::DecorationButton>& button : buttons )
+            {
+                button.data()->setGeometry( QRectF( QPoint( 0, 0 ), QSizeF( bWidth, bHeight ) ) );
+                static_cast<Button*>( button.data() )->setOffset( QPointF( 0, verticalOffset ) );
+                static_cast<Button*>( button.data() )->setIconSize( QSize( bWidth, bWidth ) );
+            }
         }
 
         // left buttons
@@ -557,46 +755,227 @@ void Decoration::createButtons()
 
         }
 
+        invalidateTransition();
         update();
 
     }
 
+    //________________________________________________________________
+    void Decoration::updatePaintState()
+    {
+        const auto c = client();
+        const auto s = settings();
+
+        m_paintState.hideTitleBar = hideTitleBar();
+        m_paintState.hasBorders = hasBorders();
+        m_paintState.leftEdge = isLeftEdge();
+        m_paintState.rightEdge = isRightEdge();
+        m_paintState.topEdge = isTopEdge();
+        m_paintState.backgroundGradient = m_internalSettings->drawBackgroundGradient();
+        m_paintState.matchColorForTitleBar = matchColorForTitleBar();
+        m_paintState.titleBarAlpha = titleBarAlpha();
+
+        // select paint routine, indexed by shaded, maximized and translucent
+        static const PaintVariant variants[2][2][2] =
+        {
+            {
+                { &Decoration::paintVariant<false, false, false>, &Decoration::paintVariant<false, false, true> },
+                { &Decoration::paintVariant<false, true, false>, &Decoration::paintVariant<false, true, true> }
+            },
+            {
+                { &Decoration::paintVariant<true, false, false>, &Decoration::paintVariant<true, false, true> },
+                { &Decoration::paintVariant<true, true, false>, &Decoration::paintVariant<true, true, true> }
+            }
+        };
+
+        m_paintVariant = variants[c->isShaded()][isMaximized()][s->isAlphaChannelSupported()];
+
+        /*
+        without rounded corners, the decoration is opaque when the titlebar is.
+        This lets the compositor skip blending and cull what is behind it
+        */
+        setOpaque( m_paintState.titleBarAlpha == 255 && ( isMaximized() || !s->isAlphaChannelSupported() ) );
+
+        invalidateTransition();
+        update();
+    }
+
     //________________________________________________________________
     void Decoration::paint(QPainter *painter, const QRect &repaintRegion)
     {
+        #if SIERRABREEZE_PAINT_VERIFICATION
+        PaintVerifier::verify( QStringLiteral( "decoration" ), size(), painter->device()->devicePixelRatioF(),
+            [this]( QPainter* verificationPainter ) { paint( verificationPainter, rect() ); } );
+        #endif
+
+        BREEZE_COUNT_ALLOCATIONS( DecorationPaint );
+        BREEZE_TRACE_SCOPE( "Decoration::paint" );
+        Statistics::PaintTimer paintTimer( this );
+        AnimationGovernor::PaintScope animationScope;
+
         // TODO: optimize based on repaintRegion
+        (this->*m_paintVariant)( painter, repaintRegion );
+    }
+
+    #if SIERRABREEZE_PAINT_VERIFICATION
+    //________________________________________________________________
+    void Decoration::verifyButtons( void )
+    {
+
+        using KDecoration2::DecorationButtonType;
+        const QList<DecorationButtonType> types = {
+            DecorationButtonType::Menu,
+            DecorationButtonType::ApplicationMenu,
+            DecorationButtonType::OnAllDesktops,
+            DecorationButtonType::Minimize,
+            DecorationButtonType::Maximize,
+            DecorationButtonType::Close,
+            DecorationButtonType::ContextHelp,
+            DecorationButtonType::Shade,
+            DecorationButtonType::KeepBelow,
+            DecorationButtonType::KeepAbove };
+
+        struct State
+        {
+            const char* name;
+            bool hovered;
+            bool pressed;
+            bool checked;
+        };
+
+        static const State states[] = {
+            { "normal", false, false, false },
+            { "hovered", true, false, false },
+            { "pressed", true, true, false },
+            { "checked", false, false, true },
+            { "checked-hovered", true, false, true } };
+
+        const qreal devicePixelRatio( qGuiApp ? qGuiApp->devicePixelRatio() : 1.0 );
+        int mismatches( 0 );
+        for( const auto type : types )
+        {
+            for( const State& state : states )
+            {
+                for( int active = 0; active < 2; ++active )
+                {
+
+                    /*
+                    a fresh button per state. It is never released over itself nor given the chance to run its timers,
+                    so that it is never clicked
+                    */
+                    std::unique_ptr<Button> button( Button::create( type, this, nullptr ) );
+                    if( !button ) continue;
+
+                    button->setVisible( true );
+                    if( state.checked )
+                    {
+                        button->setCheckable( true );
+                        button->setChecked( true );
+                    }
+
+                    button->setInteractionState( state.hovered, state.pressed );
+
+                    const QString name( QStringLiteral( "button-%1-%2-%3" )
+                        .arg( int( type ) )
+                        .arg( QLatin1String( state.name ) )
+                        .arg( active ? QStringLiteral( "active" ) : QStringLiteral( "inactive" ) ) );
+
+                    m_forcedActive = active;
+                    const QRect rect( button->geometry().toAlignedRect() );
+                    if( !PaintVerifier::verify( name, rect.size() + QSize( rect.x(), rect.y() ), devicePixelRatio,
+                        [&button, &rect]( QPainter* painter ) { button->paint( painter, rect ); } ) )
+                    { ++mismatches; }
+
+                    m_forcedActive = -1;
+                    button->setInteractionState( false, false );
+
+                }
+            }
+        }
+
+        qDebug().nospace() << "SierraBreeze: verified " << types.size()*std::size( states )*2 << " button states, "
+            << mismatches << " mismatches";
+
+    }
+    #endif
+
+    //________________________________________________________________
+    template<bool Shaded, bool Maximized, bool Translucent>
+    void Decoration::paintVariant(QPainter *painter, const QRect &repaintRegion)
+    {
+
         auto c = client();
-        auto s = settings();
 
-        // paint background
-        if( !c->isShaded() )
+        // paint background. Maximized windows have no border, only the titlebar is visible
+        if( !Shaded && !Maximized )
         {
-            painter->fillRect(rect(), Qt::transparent);
             painter->save();
             painter->setRenderHint(QPainter::Antialiasing);
             painter->setPen(Qt::NoPen);
 
             QColor winCol = this->titleBarColor();
-            winCol.setAlpha(titleBarAlpha());
+            winCol.setAlpha(m_paintState.titleBarAlpha);
             painter->setBrush(winCol);
 
-            // clip away the top part
-            if( !hideTitleBar() ) painter->setClipRect(0, borderTop(), size().width(), size().height() - borderTop(), Qt::IntersectClip);
+            /*
+            only the borders are painted: one block per corner, large enough to contain the rounded corner,
+            and the strips in between, so that the cost grows with the window perimeter rather than its area.
+            The titlebar covers the top part, unless hidden
+            */
+            const int width( size().width() );
+            const int height( size().height() );
+            const int radius( Translucent ? Metrics::Frame_FrameRadius : 0 );
+            const int top( m_paintState.hideTitleBar ? 0 : borderTop() );
+
+            const int leftWidth( qMax( radius, borderLeft() ) );
+            const int rightWidth( qMax( radius, borderRight() ) );
+            const int bottomHeight( qMax( radius, borderBottom() ) );
+            const int topHeight( m_paintState.hideTitleBar ? qMax( radius, borderTop() ) : 0 );
+
+            if( BREEZE_REFERENCE_PAINT || width < leftWidth + rightWidth || height - top < topHeight + bottomHeight )
+            {
+
+                // reference, and windows too small for the corners to be painted separately
+                if( !m_paintState.hideTitleBar ) painter->setClipRect(0, borderTop(), width, height - borderTop(), Qt::IntersectClip);
+
+                if( Translucent ) painter->drawRoundedRect(rect(), Metrics::Frame_FrameRadius, Metrics::Frame_FrameRadius);
+                else painter->drawRect( rect() );
 
-            if( s->isAlphaChannelSupported() ) painter->drawRoundedRect(rect(), Metrics::Frame_FrameRadius, Metrics::Frame_FrameRadius);
-            else painter->drawRect( rect() );
+            } else {
+
+                // corners
+                paintFrameCorner( painter, QRect( 0, height - bottomHeight, leftWidth, bottomHeight ), Qt::BottomLeftCorner, radius );
+                paintFrameCorner( painter, QRect( width - rightWidth, height - bottomHeight, rightWidth, bottomHeight ), Qt::BottomRightCorner, radius );
+                if( m_paintState.hideTitleBar )
+                {
+                    paintFrameCorner( painter, QRect( 0, 0, leftWidth, topHeight ), Qt::TopLeftCorner, radius );
+                    paintFrameCorner( painter, QRect( width - rightWidth, 0, rightWidth, topHeight ), Qt::TopRightCorner, radius );
+                }
+
+                // sides
+                const int sideTop( top + topHeight );
+                const int sideHeight( height - bottomHeight - sideTop );
+                painter->drawRect( QRect( 0, sideTop, borderLeft(), sideHeight ) );
+                painter->drawRect( QRect( width - borderRight(), sideTop, borderRight(), sideHeight ) );
+
+                // bottom, and top if the titlebar is hidden
+                painter->drawRect( QRect( leftWidth, height - borderBottom(), width - leftWidth - rightWidth, borderBottom() ) );
+                if( m_paintState.hideTitleBar ) painter->drawRect( QRect( leftWidth, 0, width - leftWidth - rightWidth, borderTop() ) );
+
+            }
 
             painter->restore();
         }
 
-        if( !hideTitleBar() ) paintTitleBar(painter, repaintRegion);
+        if( !m_paintState.hideTitleBar && !paintTitleBarTransition<Shaded, Maximized, Translucent>(painter) )
+        { paintTitleBar<Shaded, Maximized, Translucent>(painter, repaintRegion); }
 
-        if( hasBorders() && !s->isAlphaChannelSupported() )
+        if( !Translucent && !Maximized && m_paintState.hasBorders )
         {
             painter->save();
             painter->setRenderHint(QPainter::Antialiasing, false);
             painter->setBrush( Qt::NoBrush );
-            painter->setPen( c->isActive() ?
+            painter->setPen( isActive() ?
                 c->color( ColorGroup::Active, ColorRole::TitleBar ):
                 c->color( ColorGroup::Inactive, ColorRole::Foreground ) );
 
@@ -607,11 +986,12 @@ void Decoration::createButtons()
     }
 
     //________________________________________________________________
+    template<bool Shaded, bool Maximized, bool Translucent>
     void Decoration::paintTitleBar(QPainter *painter, const QRect &repaintRegion)
     {
+        BREEZE_TRACE_SCOPE( "Decoration::paintTitleBar" );
+
         const auto c = client();
-        // TODO Review this. Here the window color is appended in matchedTitleBarColor var
-        const QColor matchedTitleBarColor(c->palette().color(QPalette::Window));
         const QRect titleRect(QPoint(0, 0), QSize(size().width(), borderTop()));
 
         if ( !titleRect.intersects(repaintRegion) ) return;
@@ -619,37 +999,47 @@ void Decoration::createButtons()
         painter->save();
         painter->setPen(Qt::NoPen);
 
+        // TODO Review this. Initialize titleBarColor based on user's choise.
+        QColor titleBarColor( m_paintState.matchColorForTitleBar ? m_colorState.window : this->titleBarColor() );
+        titleBarColor.setAlpha(m_paintState.titleBarAlpha);
+
         // render a linear gradient on title area
-        if ( c->isActive() && m_internalSettings->drawBackgroundGradient() )
+        if ( m_paintState.backgroundGradient && isActive() )
         {
 
-            // TODO Review this. Initialize titleBarColor based on user's choise.
-            QColor titleBarColor(matchColorForTitleBar()  ? matchedTitleBarColor : this->titleBarColor() );
-            titleBarColor.setAlpha(titleBarAlpha());
+            const auto gradient = [&titleBarColor, &titleRect]()
+            {
+                QLinearGradient gradient( 0, 0, 0, titleRect.height() );
+                gradient.setColorAt(0.0, titleBarColor.lighter( 120 ) );
+                gradient.setColorAt(0.8, titleBarColor);
+                return QBrush( gradient );
+            };
 
-            QLinearGradient gradient( 0, 0, 0, titleRect.height() );
-            gradient.setColorAt(0.0, titleBarColor.lighter( 120 ) );
-            gradient.setColorAt(0.8, titleBarColor);
-            painter->setBrush(gradient);
+            // the gradient stops are heap allocated, only rebuild the brush when its inputs change
+            if( BREEZE_REFERENCE_PAINT ) painter->setBrush( gradient() );
+            else {
 
-        } else {
+                if( titleBarColor != m_gradientColor || titleRect.height() != m_gradientHeight )
+                {
+                    m_gradientBrush = gradient();
+                    m_gradientColor = titleBarColor;
+                    m_gradientHeight = titleRect.height();
+                }
 
-            // TODO Review this. Initialize titleBarColor based on user's choise.
-            // I needed another else if because the window might not be active or has drawBackgroundGradient but
-            QColor titleBarColor(matchColorForTitleBar()  ? matchedTitleBarColor : this->titleBarColor() );
-            titleBarColor.setAlpha(titleBarAlpha());
+                painter->setBrush(m_gradientBrush);
 
-            painter->setBrush(titleBarColor);
+            }
 
-        }
+        } else painter->setBrush(titleBarColor);
 
-        auto s = settings();
-        if( isMaximized() || !s->isAlphaChannelSupported() )
+        if( Maximized || !Translucent )
         {
 
+            // plain rectangle, no need for antialiasing
+            painter->setRenderHint( QPainter::Antialiasing, false );
             painter->drawRect(titleRect);
 
-        } else if( c->isShaded() ) {
+        } else if( Shaded ) {
 
             painter->drawRoundedRect(titleRect, Metrics::Frame_FrameRadius, Metrics::Frame_FrameRadius);
 
@@ -659,16 +1049,16 @@ void Decoration::createButtons()
 
             // the rect is made a little bit larger to be able to clip away the rounded corners at the bottom and sides
             painter->drawRoundedRect(titleRect.adjusted(
-                isLeftEdge() ? -Metrics::Frame_FrameRadius:0,
-                isTopEdge() ? -Metrics::Frame_FrameRadius:0,
-                isRightEdge() ? Metrics::Frame_FrameRadius:0,
+                m_paintState.leftEdge ? -Metrics::Frame_FrameRadius:0,
+                m_paintState.topEdge ? -Metrics::Frame_FrameRadius:0,
+                m_paintState.rightEdge ? Metrics::Frame_FrameRadius:0,
                 Metrics::Frame_FrameRadius),
                 Metrics::Frame_FrameRadius, Metrics::Frame_FrameRadius);
 
         }
 
         const QColor outlineColor( this->outlineColor() );
-        if( !c->isShaded() && outlineColor.isValid() )
+        if( !Shaded && outlineColor.isValid() )
         {
             // outline
             painter->setRenderHint( QPainter::Antialiasing, false );
@@ -680,18 +1070,82 @@ void Decoration::createButtons()
         painter->restore();
 
         // draw caption
-        painter->setFont(s->font());
+        painter->setFont(settings()->font());
         painter->setPen( fontColor() );
 
         const auto cR = captionRect();
-        const QString caption = painter->fontMetrics().elidedText(c->caption(), Qt::ElideMiddle, cR.first.width());
-        painter->drawText(cR.first, cR.second | Qt::TextSingleLine, caption);
+        if( BREEZE_REFERENCE_PAINT )
+        {
+
+            const QString caption( painter->fontMetrics().elidedText( c->caption(), Qt::ElideMiddle, cR.first.width() ) );
+            painter->drawText(cR.first, cR.second | Qt::TextSingleLine, caption);
+
+        } else {
+
+            if( m_elidedCaptionWidth != cR.first.width() || m_elidedCaptionSource != c->caption() )
+            {
+                m_elidedCaptionSource = c->caption();
+                m_elidedCaptionWidth = cR.first.width();
+                m_elidedCaption = painter->fontMetrics().elidedText(m_elidedCaptionSource, Qt::ElideMiddle, m_elidedCaptionWidth);
+            }
+
+            painter->drawText(cR.first, cR.second | Qt::TextSingleLine, m_elidedCaption);
+
+        }
 
         // draw all buttons
         m_leftButtons->paint(painter, repaintRegion);
         m_rightButtons->paint(painter, repaintRegion);
     }
 
+    //________________________________________________________________
+    template<bool Shaded, bool Maximized, bool Translucent>
+    bool Decoration::paintTitleBarTransition(QPainter *painter)
+    {
+
+        /*
+        during the active state change animation, the titlebar is rendered once as fully inactive and once as fully active,
+        and each frame blends the two surfaces instead of repainting the gradient, the caption and the buttons with mixed colors
+        */
+        if( BREEZE_REFERENCE_PAINT || !isAnimating() || !Rasterizer::isEnabled() ) return false;
+        if( painter->transform().type() > QTransform::TxTranslate ) return false;
+
+        // a button hover animation would be frozen in the surfaces
+        if( hasAnimatedButtons() ) return false;
+
+        const qreal devicePixelRatio( painter->device()->devicePixelRatioF() );
+        const QRect titleRect( 0, 0, size().width(), borderTop() );
+        const QSize deviceSize( std::ceil( titleRect.width()*devicePixelRatio ), std::ceil( titleRect.height()*devicePixelRatio ) );
+        if( deviceSize.isEmpty() ) return false;
+
+        if( m_transitionFrame.size() != deviceSize || m_transitionFrame.devicePixelRatio() != devicePixelRatio )
+        {
+            BREEZE_TRACE_SCOPE( "Decoration::renderTransition" );
+
+            for( int active = 0; active < 2; ++active )
+            {
+                QImage& surface( m_transitionSurfaces[active] );
+                surface = QImage( deviceSize, QImage::Format_ARGB32_Premultiplied );
+                surface.setDevicePixelRatio( devicePixelRatio );
+                surface.fill( Qt::transparent );
+
+                m_forcedActive = active;
+                QPainter surfacePainter( &surface );
+                surfacePainter.setRenderHints( painter->renderHints() );
+                paintTitleBar<Shaded, Maximized, Translucent>( &surfacePainter, titleRect );
+            }
+
+            m_forcedActive = -1;
+            m_transitionFrame = QImage( deviceSize, QImage::Format_ARGB32_Premultiplied );
+            m_transitionFrame.setDevicePixelRatio( devicePixelRatio );
+        }
+
+        Rasterizer::crossfade( m_transitionFrame, m_transitionSurfaces[0], m_transitionSurfaces[1], m_opacity );
+        painter->drawImage( titleRect.topLeft(), m_transitionFrame );
+        return true;
+
+    }
+
     //________________________________________________________________
     int Decoration::buttonHeight() const
     {
@@ -762,87 +1216,40 @@ void Decoration::createButtons()
     //________________________________________________________________
     void Decoration::createShadow()
     {
+        BREEZE_TRACE_SCOPE( "Decoration::createShadow" );
 
-        // assign global shadow if exists and parameters match
-        if(
-            !g_sShadow  ||
-            g_shadowSize != m_internalSettings->shadowSize() ||
-            g_shadowStrength != m_internalSettings->shadowStrength() ||
-            g_shadowColor != m_internalSettings->shadowColor()
-            )
+        // no shadow around maximized windows. It is restored when the window is unmaximized
+        if( isMaximized() )
         {
-            // assign parameters
-            g_shadowSize = m_internalSettings->shadowSize();
-            g_shadowStrength = m_internalSettings->shadowStrength();
-            g_shadowColor = m_internalSettings->shadowColor();
-            const int shadowOffset = qMax( 6*g_shadowSize/16, Metrics::Shadow_Overlap*2 );
-
-            // create image
-            QImage image(2*g_shadowSize, 2*g_shadowSize, QImage::Format_ARGB32_Premultiplied);
-            image.fill(Qt::transparent);
-
-            // create gradient
-            // gaussian delta function
-            auto alpha = [](qreal x) { return std::exp( -x*x/0.15 ); };
-
-            // color calculation delta function
-            auto gradientStopColor = [](QColor color, int alpha)
-            {
-                color.setAlpha(alpha);
-                return color;
-            };
-
-            QRadialGradient radialGradient( g_shadowSize, g_shadowSize, g_shadowSize );
-            for( int i = 0; i < 10; ++i )
-            {
-                const qreal x( qreal( i )/9 );
-                radialGradient.setColorAt(x,  gradientStopColor( g_shadowColor, alpha(x)*g_shadowStrength ) );
-            }
-
-            radialGradient.setColorAt(1, gradientStopColor( g_shadowColor, 0 ) );
-
-            // fill
-            painter.begin(&image);
-            //TODO review these
-            //QPainter painter(&image);
-            painter.setRenderHint( QPainter::Antialiasing, true );
-            painter.fillRect( image.rect(), radialGradient);
-
-            // contrast pixel
-            QRectF innerRect = QRectF(
-                g_shadowSize - Metrics::Shadow_Overlap, g_shadowSize - shadowOffset - Metrics::Shadow_Overlap,
-                2*Metrics::Shadow_Overlap, shadowOffset + 2*Metrics::Shadow_Overlap );
-                // g_shadowSize - shadowOffset - Metrics::Shadow_Overlap, g_shadowSize - shadowOffset - Metrics::Shadow_Overlap,
-                // shadowOffset + 2*Metrics::Shadow_Overlap, shadowOffset + 2*Metrics::Shadow_Overlap );
-
-            painter.setPen( gradientStopColor( g_shadowColor, g_shadowStrength*0.5 ) );
-            painter.setBrush( Qt::NoBrush );
-            painter.drawRoundedRect( innerRect, -0.5 + Metrics::Frame_FrameRadius, -0.5 + Metrics::Frame_FrameRadius );
-
-            // mask out inner rect
-            painter.setPen( Qt::NoPen );
-            painter.setBrush( Qt::black );
-            painter.setCompositionMode(QPainter::CompositionMode_DestinationOut );
-            painter.drawRoundedRect( innerRect, 0.5 + Metrics::Frame_FrameRadius, 0.5 + Metrics::Frame_FrameRadius );
+            setShadow( std::shared_ptr<KDecoration2::DecorationShadow>() );
+            return;
+        }
 
-            painter.end();
+        // assign global shadow if one exists for these parameters
+        const int shadowSize = m_internalSettings->shadowSize();
+        const int shadowStrength = m_internalSettings->shadowStrength();
+        const QColor shadowColor = m_internalSettings->shadowColor();
+        const ShadowKey key{ shadowSize, shadowStrength, shadowColor.rgba() };
 
-            g_sShadow = std::make_shared<KDecoration2::DecorationShadow>();
-            g_sShadow->setPadding( QMargins(
-                // g_shadowSize - shadowOffset - Metrics::Shadow_Overlap,
-                g_shadowSize - Metrics::Shadow_Overlap,
-                g_shadowSize - shadowOffset - Metrics::Shadow_Overlap,
-                g_shadowSize - Metrics::Shadow_Overlap,
-                g_shadowSize - Metrics::Shadow_Overlap ) );
+        std::shared_ptr<KDecoration2::DecorationShadow> shadow( g_shadows.value( key ) );
+        if( !shadow )
+        {
+            Statistics::recordCacheAccess( Statistics::ShadowCache, false );
+            Statistics::recordShadowRegeneration( this );
 
-            g_sShadow->setInnerShadowRect(QRect( g_shadowSize, g_shadowSize, 1, 1) );
+            shadow = std::make_shared<KDecoration2::DecorationShadow>();
+            shadow->setPadding( ShadowRenderer::padding( shadowSize ) );
+            shadow->setInnerShadowRect( ShadowRenderer::innerShadowRect( shadowSize ) );
+            shadow->setShadow( ShadowRenderer::image( shadowSize, shadowStrength, shadowColor ) );
 
-            // assign image
-            g_sShadow->setShadow(image);
+            // drop shadows no longer used by any window, then store
+            using ShadowIterator = QHash<ShadowKey, std::shared_ptr<KDecoration2::DecorationShadow>>::iterator;
+            g_shadows.removeIf( []( ShadowIterator iter ) { return iter.value().use_count() == 1; } );
+            g_shadows.insert( key, shadow );
 
-        }
+        } else Statistics::recordCacheAccess( Statistics::ShadowCache, true );
 
-        setShadow(g_sShadow);
+        setShadow(shadow);
 
     }
 
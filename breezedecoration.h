@@ -24,11 +24,13 @@
 
 #include "breeze.h"
 #include "breezesettings.h"
+#include "config-breeze.h"
 
 #include <KDecoration2/Decoration>
 #include <KDecoration2/DecoratedClient>
 #include <KDecoration2/DecorationSettings>
 
+#include <QImage>
 #include <QPalette>
 #include <QPropertyAnimation>
 #include <QVariant>
@@ -84,8 +86,18 @@ namespace SierraBreeze
         QColor titleBarColor( void ) const;
         QColor outlineColor( void ) const;
         QColor fontColor( void ) const;
+
+        QColor warningColor( void ) const
+        { return m_colorState.warning; }
         //@}
 
+        //* active state used for painting. Forced while rendering the focus transition surfaces
+        bool isActive( void ) const
+        { return m_forcedActive >= 0 ? m_forcedActive : client()->isActive(); }
+
+        //* discard the focus transition surfaces, when something they show changes
+        void invalidateTransition( void );
+
         //*@name maximization modes
         //@{
         inline bool isMaximized( void ) const;
@@ -104,6 +116,9 @@ namespace SierraBreeze
         public Q_SLOTS:
         bool init() override;
 
+        //* apply settings reloaded by the provider. Empty keys means the window's exception may have changed
+        void updateSettings( const QStringList& );
+
         private Q_SLOTS:
         void reconfigure();
         void recalculateBorders();
@@ -113,6 +128,8 @@ namespace SierraBreeze
         void updateAnimationState();
         void updateSizeGripVisibility();
         void updateBlur();
+        void updatePaintState();
+        void updateColorState();
 
         private:
 
@@ -120,11 +137,35 @@ namespace SierraBreeze
         QPair<QRect,Qt::Alignment> captionRect( void ) const;
 
         void createButtons();
+
+        //*@name paint routines, specialized for shaded, maximized and translucent windows
+        //@{
+        template<bool Shaded, bool Maximized, bool Translucent>
+        void paintVariant(QPainter *painter, const QRect &repaintRegion);
+
+        template<bool Shaded, bool Maximized, bool Translucent>
         void paintTitleBar(QPainter *painter, const QRect &repaintRegion);
+
+        template<bool Shaded, bool Maximized, bool Translucent>
+        bool paintTitleBarTransition(QPainter *painter);
+        //@}
+
+        //* true while the active state change animation interpolates colors
+        bool isAnimating( void ) const
+        { return m_forcedActive < 0 && m_animation->state() == QAbstractAnimation::Running; }
+
+        //* true if a button runs its own hover animation
+        bool hasAnimatedButtons( void ) const;
+
         void createShadow();
 
         void setScaledCornerRadius();
 
+        #if SIERRABREEZE_PAINT_VERIFICATION
+        //* verify every button type in every state, active and inactive, on temporary offscreen buttons
+        void verifyButtons( void );
+        #endif
+
         //*@name border size
         //@{
         int borderSize(bool bottom = false) const;
@@ -149,12 +190,78 @@ namespace SierraBreeze
         //* active state change opacity
         qreal m_opacity = 0;
 
+        //* window state used for painting, resolved in updatePaintState
+        struct PaintState
+        {
+            bool hideTitleBar = false;
+            bool hasBorders = false;
+            bool leftEdge = false;
+            bool rightEdge = false;
+            bool topEdge = false;
+            bool backgroundGradient = false;
+            bool matchColorForTitleBar = false;
+            int titleBarAlpha = 255;
+        };
+
+        PaintState m_paintState;
+
+        //* colors, resolved in updateColorState when the palette or the settings change
+        struct ColorState
+        {
+            //* number of steps of the inactive to active interpolation tables
+            static constexpr int Steps = 64;
+
+            //*@name endpoints, indexed by active state
+            //@{
+            QColor titleBar[2];
+            QColor font[2];
+            //@}
+
+            QColor highlight;
+            QColor window;
+            QColor warning;
+            bool drawSeparator = false;
+
+            //*@name interpolated colors, indexed by animation progress
+            //@{
+            QRgb titleBarSteps[Steps + 1] = {};
+            QRgb fontSteps[Steps + 1] = {};
+            //@}
+
+            //* table entry for a given animation progress
+            static int step( qreal opacity )
+            { return qBound( 0, qRound( opacity*Steps ), int( Steps ) ); }
+        };
+
+        ColorState m_colorState;
+
+        //* paint routine matching the current window state
+        using PaintVariant = void (Decoration::*)(QPainter*, const QRect&);
+        PaintVariant m_paintVariant;
+
         //*frame corner radius, scaled according to DPI
         qreal m_scaledCornerRadius = 3;
 
-        //TODO Review this
-        QPainter painter;
-        const QRect repaintRegion;
+        //*@name elided caption, cached between repaints
+        //@{
+        QString m_elidedCaption;
+        QString m_elidedCaptionSource;
+        int m_elidedCaptionWidth = -1;
+        //@}
+
+        //*@name focus transition: titlebar rendered once per active state, then crossfaded
+        //@{
+        QImage m_transitionSurfaces[2];
+        QImage m_transitionFrame;
+        int m_forcedActive = -1;
+        //@}
+
+        //*@name titlebar gradient, cached between repaints
+        //@{
+        QBrush m_gradientBrush;
+        QColor m_gradientColor;
+        int m_gradientHeight = -1;
+        //@}
 
     };
 
@@ -54,6 +54,7 @@ namespace SierraBreeze
             configuration->setEnabled( exception.enabled() );
             configuration->setExceptionType( exception.exceptionType() );
             configuration->setExceptionPattern( exception.exceptionPattern() );
+            configuration->setExceptionPatternKind( exception.exceptionPatternKind() );
             configuration->setMask( exception.mask() );
 
             // propagate all features found in mask to the output configuration
@@ -68,24 +69,30 @@ namespace SierraBreeze
     }
 
     //______________________________________________________________
-    void ExceptionList::writeConfig( KSharedConfig::Ptr config )
+    bool ExceptionList::writeConfig( KSharedConfig::Ptr config )
     {
 
-        // remove all existing exceptions
-        QString groupName;
-        for( int index = 0; config->hasGroup( groupName = exceptionGroupName( index ) ); ++index )
-        { config->deleteGroup( groupName ); }
-
-        // rewrite current exceptions
+        // update current exceptions in place. Only entries that differ are written
+        bool changed( false );
         int index = 0;
         foreach( const InternalSettingsPtr& exception, _exceptions )
         {
 
-            writeConfig( exception.data(), config.data(), exceptionGroupName( index ) );
+            if( writeConfig( exception.data(), config.data(), exceptionGroupName( index ) ) ) changed = true;
             ++index;
 
         }
 
+        // remove exceptions past the end of the list
+        QString groupName;
+        for( ; config->hasGroup( groupName = exceptionGroupName( index ) ); ++index )
+        {
+            config->deleteGroup( groupName );
+            changed = true;
+        }
+
+        return changed;
+
     }
 
     //_______________________________________________________________________
@@ -93,13 +100,14 @@ namespace SierraBreeze
     { return QString( "Windeco Exception %1" ).arg( index ); }
 
     //______________________________________________________________
-    void ExceptionList::writeConfig( KCoreConfigSkeleton* skeleton, KConfig* config, const QString& groupName )
+    bool ExceptionList::writeConfig( KCoreConfigSkeleton* skeleton, KConfig* config, const QString& groupName )
     {
 
         // list of items to be written
-        QStringList keys = { "Enabled", "ExceptionPattern", "ExceptionType", "HideTitleBar", "Mask", "BorderSize"};
+        QStringList keys = { "Enabled", "ExceptionPattern", "ExceptionPatternKind", "ExceptionType", "HideTitleBar", "Mask", "BorderSize"};
 
-        // write all items
+        // write items whose stored value differs
+        bool changed( false );
         foreach( auto key, keys )
         {
             KConfigSkeletonItem* item( skeleton->findItem( key ) );
@@ -107,10 +115,17 @@ namespace SierraBreeze
 
             if( !groupName.isEmpty() ) item->setGroup( groupName );
             KConfigGroup configGroup( config, item->group() );
-            configGroup.writeEntry( item->key(), item->property() );
+
+            const QVariant value( item->property() );
+            if( configGroup.hasKey( item->key() ) && configGroup.readEntry( item->key(), QString() ) == value.toString() ) continue;
+
+            configGroup.writeEntry( item->key(), value );
+            changed = true;
 
         }
 
+        return changed;
+
     }
 
     //______________________________________________________________
@@ -53,19 +53,19 @@ namespace SierraBreeze
         //! read from KConfig
         void readConfig( KSharedConfig::Ptr );
 
-        //! write to kconfig
-        void writeConfig( KSharedConfig::Ptr );
-
-        protected:
+        //! write to kconfig. Returns true if the stored exceptions changed
+        bool writeConfig( KSharedConfig::Ptr );
 
         //! generate exception group name for given exception index
         static QString exceptionGroupName( int index );
 
+        protected:
+
         //! read configuration
         static void readConfig( KCoreConfigSkeleton*, KConfig*, const QString& );
 
-        //! write configuration
-        static void writeConfig( KCoreConfigSkeleton*, KConfig*, const QString& );
+        //! write configuration. Returns true if an entry changed
+        static bool writeConfig( KCoreConfigSkeleton*, KConfig*, const QString& );
 
         private:
 
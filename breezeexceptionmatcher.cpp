@@ -0,0 +1,391 @@
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breezeexceptionmatcher.h"
+#include "breezepatternanalyzer.h"
+
+#include <QDebug>
+
+#include <limits>
+
+namespace SierraBreeze
+{
+
+    namespace
+    {
+
+        //* resource name and class, from the class name string
+        QStringView resourceName( const QString& className )
+        {
+            const int space( className.indexOf( QLatin1Char( ' ' ) ) );
+            return space < 0 ? QStringView( className ) : QStringView( className ).left( space );
+        }
+
+        //* resource class, from the class name string
+        QStringView resourceClass( const QString& className )
+        {
+            const int space( className.indexOf( QLatin1Char( ' ' ) ) );
+            return space < 0 ? QStringView() : QStringView( className ).mid( space + 1 );
+        }
+
+        //* end of a bounded sequence starting at given position, such as {...} or <...>, -1 if unterminated
+        int delimitedEnd( const QString& pattern, int i )
+        {
+            const QChar open( pattern[i] );
+            const QChar close( open == QLatin1Char( '{' ) ? QLatin1Char( '}' ) : open == QLatin1Char( '<' ) ? QLatin1Char( '>' ) : open );
+            const int end( pattern.indexOf( close, i+1 ) );
+            return end < 0 ? -1 : end+1;
+        }
+
+        //* end of the escape sequence starting at given backslash, including its arguments
+        int escapeEnd( const QString& pattern, int i )
+        {
+            const int size( pattern.size() );
+            if( i+1 >= size ) return size;
+
+            const QChar c( pattern[i+1] );
+            int end( i+2 );
+
+            // back references and octal codes
+            if( c.isDigit() )
+            {
+                while( end < size && pattern[end].isDigit() ) ++end;
+                return end;
+            }
+
+            switch( c.unicode() )
+            {
+                // control character
+                case 'c': return qMin( end+1, size );
+
+                // hexadecimal and octal codes, properties, named characters and references
+                case 'x': case 'o': case 'p': case 'P': case 'N': case 'g': case 'k':
+                {
+                    if( end < size && QStringView( u"{<'" ).contains( pattern[end] ) )
+                    {
+                        const int delimited( delimitedEnd( pattern, end ) );
+                        return delimited < 0 ? size : delimited;
+                    }
+
+                    if( c == QLatin1Char( 'x' ) )
+                    {
+                        for( int count = 0; count < 2 && end < size && QStringView( u"0123456789abcdefABCDEF" ).contains( pattern[end] ); ++count ) ++end;
+                    } else if( c == QLatin1Char( 'p' ) || c == QLatin1Char( 'P' ) ) {
+                        if( end < size ) ++end;
+                    } else if( c == QLatin1Char( 'g' ) ) {
+                        if( end < size && ( pattern[end] == QLatin1Char( '-' ) || pattern[end] == QLatin1Char( '+' ) ) ) ++end;
+                        while( end < size && pattern[end].isDigit() ) ++end;
+                    }
+
+                    return end;
+                }
+
+                default: return end;
+            }
+        }
+
+        //* end of the counted quantifier starting at given brace, -1 if the brace is not a quantifier
+        int quantifierEnd( const QString& pattern, int i )
+        {
+            const int size( pattern.size() );
+            if( i >= size || pattern[i] != QLatin1Char( '{' ) ) return -1;
+
+            int end( i+1 );
+            bool digits( false );
+            bool comma( false );
+            for( ; end < size && pattern[end] != QLatin1Char( '}' ); ++end )
+            {
+                if( pattern[end].isDigit() ) digits = true;
+                else if( pattern[end] == QLatin1Char( ',' ) && !comma ) comma = true;
+                else if( pattern[end] != QLatin1Char( ' ' ) ) return -1;
+            }
+
+            return ( end < size && digits ) ? end+1 : -1;
+        }
+
+    }
+
+    //__________________________________________________________________
+    void ExceptionMatcher::build( const InternalSettingsList& exceptions, const QSet<int>& ignored )
+    {
+
+        m_rules.clear();
+        m_scanned.clear();
+        m_classLiterals.clear();
+        m_titleLiterals.clear();
+        m_uses[0] = m_uses[1] = false;
+        m_refused.clear();
+
+        m_rules.reserve( exceptions.size() );
+        for( int index = 0; index < exceptions.size(); ++index )
+        {
+
+            const auto& exception( exceptions[index] );
+
+            Rule rule;
+            rule.type = exception->exceptionType() == InternalSettings::ExceptionWindowTitle ? InternalSettings::ExceptionWindowTitle : InternalSettings::ExceptionWindowClassName;
+            rule.kind = exception->exceptionPatternKind();
+
+            const QString pattern( exception->exceptionPattern() );
+            rule.active = exception->enabled() && !pattern.isEmpty() && !ignored.contains( index );
+            if( rule.active )
+            {
+
+                switch( rule.kind )
+                {
+
+                    case InternalSettings::PatternLiteral:
+                    {
+                        rule.literal = pattern;
+
+                        // first rule wins
+                        auto& literals( rule.type == InternalSettings::ExceptionWindowTitle ? m_titleLiterals : m_classLiterals );
+                        if( !literals.contains( pattern ) ) literals.insert( pattern, index );
+                        break;
+                    }
+
+                    case InternalSettings::PatternGlob:
+                    {
+                        rule.expression.setPattern( regularExpression( pattern, rule.kind ) );
+                        m_scanned.append( index );
+                        break;
+                    }
+
+                    default:
+                    case InternalSettings::PatternRegExp:
+                    {
+                        rule.kind = InternalSettings::PatternRegExp;
+                        rule.literal = requiredLiteral( pattern );
+                        rule.expression.setPattern( pattern );
+                        m_scanned.append( index );
+                        break;
+                    }
+
+                }
+
+                // compile once, rather than on every window
+                if( rule.kind != InternalSettings::PatternLiteral )
+                {
+                    rule.expression.optimize();
+                    rule.active = rule.expression.isValid();
+                }
+
+                m_uses[ rule.type == InternalSettings::ExceptionWindowTitle ] |= rule.active;
+
+            }
+
+            m_rules.append( rule );
+
+        }
+
+    }
+
+    //__________________________________________________________________
+    int ExceptionMatcher::match( const QString& className, const QString& title ) const
+    {
+
+        // literals
+        int best( std::numeric_limits<int>::max() );
+        if( !m_classLiterals.isEmpty() && !className.isEmpty() )
+        {
+            best = qMin( best, m_classLiterals.value( resourceName( className ).toString(), best ) );
+            best = qMin( best, m_classLiterals.value( resourceClass( className ).toString(), best ) );
+        }
+
+        if( !m_titleLiterals.isEmpty() )
+        { best = qMin( best, m_titleLiterals.value( title, best ) ); }
+
+        // other rules, only those of higher priority than the literal match
+        for( int index : m_scanned )
+        {
+            if( index >= best ) break;
+            if( matches( index, className, title ) ) return index;
+        }
+
+        return best == std::numeric_limits<int>::max() ? -1 : best;
+
+    }
+
+    //__________________________________________________________________
+    bool ExceptionMatcher::matches( int index, const QString& className, const QString& title ) const
+    {
+
+        if( index < 0 || index >= m_rules.size() ) return false;
+
+        const Rule& rule( m_rules[index] );
+        if( !rule.active || rule.refused ) return false;
+
+        const bool isTitle( rule.type == InternalSettings::ExceptionWindowTitle );
+        if( rule.kind == InternalSettings::PatternLiteral )
+        {
+            if( isTitle ) return title == rule.literal;
+            return resourceName( className ) == rule.literal || resourceClass( className ) == rule.literal;
+        }
+
+        const QString& value( isTitle ? title : className );
+
+        // skip the expression if a substring it needs is missing
+        if( !rule.literal.isEmpty() && !value.contains( rule.literal ) ) return false;
+
+        const qint64 start( PatternAnalyzer::threadTime() );
+
+        bool matched( false );
+        if( rule.kind == InternalSettings::PatternGlob && !isTitle )
+        {
+            matched =
+                rule.expression.matchView( resourceName( className ) ).hasMatch() ||
+                rule.expression.matchView( resourceClass( className ) ).hasMatch();
+        } else matched = rule.expression.match( value ).hasMatch();
+
+        // expensive patterns missed when loading are ignored from now on, once they are consistently over budget
+        const qint64 elapsed( PatternAnalyzer::threadTime() - start );
+        if( elapsed <= PatternAnalyzer::WorstCaseBudget )
+        {
+            rule.strikes = 0;
+            return matched;
+        }
+
+        if( ++rule.strikes < RefusalStrikes ) return matched;
+
+        qWarning().nospace() << "SierraBreeze: exception pattern " << rule.expression.pattern() << " took "
+            << elapsed/1000 << "us to match, " << RefusalStrikes << " times in a row, it is ignored";
+        rule.refused = true;
+        m_refused.append( index );
+        return false;
+
+    }
+
+    //__________________________________________________________________
+    QList<int> ExceptionMatcher::takeRefused( void ) const
+    {
+        QList<int> out;
+        out.swap( m_refused );
+        return out;
+    }
+
+    //__________________________________________________________________
+    QString ExceptionMatcher::regularExpression( const QString& pattern, int patternKind )
+    {
+        switch( patternKind )
+        {
+            case InternalSettings::PatternLiteral:
+            return QRegularExpression::anchoredPattern( QRegularExpression::escape( pattern ) );
+
+            case InternalSettings::PatternGlob:
+            return QRegularExpression::wildcardToRegularExpression( pattern, QRegularExpression::NonPathWildcardConversion );
+
+            default:
+            case InternalSettings::PatternRegExp:
+            return pattern;
+        }
+    }
+
+    //__________________________________________________________________
+    QString ExceptionMatcher::requiredLiteral( const QString& pattern )
+    {
+
+        // with alternatives, or options such as case insensitivity, no substring is certain
+        if( pattern.contains( QLatin1Char( '|' ) ) || pattern.contains( QLatin1String( "(?" ) ) || pattern.contains( QLatin1String( "\\Q" ) ) )
+        { return QString(); }
+
+        QString best;
+        QString run;
+        const auto endRun = [&best, &run]()
+        {
+            if( run.size() > best.size() ) best = run;
+            run.clear();
+        };
+
+        const int size( pattern.size() );
+        int depth( 0 );
+        for( int i = 0; i < size; )
+        {
+
+            const QChar c( pattern[i] );
+
+            // character class
+            if( c == QLatin1Char( '[' ) )
+            {
+                endRun();
+                int end( i+1 );
+                if( end < size && pattern[end] == QLatin1Char( '^' ) ) ++end;
+                if( end < size && pattern[end] == QLatin1Char( ']' ) ) ++end;
+                for( ; end < size && pattern[end] != QLatin1Char( ']' ); ++end )
+                { if( pattern[end] == QLatin1Char( '\\' ) ) ++end; }
+                i = end + 1;
+                continue;
+            }
+
+            // group content may be optional or repeated. Only the top level is considered
+            if( c == QLatin1Char( '(' ) || c == QLatin1Char( ')' ) || depth > 0 )
+            {
+                endRun();
+                if( c == QLatin1Char( '(' ) ) ++depth;
+                else if( c == QLatin1Char( ')' ) ) --depth;
+                i = ( c == QLatin1Char( '\\' ) ) ? escapeEnd( pattern, i ) : i+1;
+                continue;
+            }
+
+            // counted quantifier, following a class, a group or an escape sequence
+            if( c == QLatin1Char( '{' ) )
+            {
+                endRun();
+                const int end( quantifierEnd( pattern, i ) );
+                i = end < 0 ? i+1 : end;
+                continue;
+            }
+
+            // literal character, possibly escaped. Escapes with a letter or digit are character types, codes or references
+            QChar literal;
+            int next( i+1 );
+            if( c == QLatin1Char( '\\' ) )
+            {
+                if( next < size && !pattern[next].isLetterOrNumber() ) literal = pattern[next];
+                next = escapeEnd( pattern, i );
+            } else if( !QStringView( u".^$*+?}" ).contains( c ) ) literal = c;
+
+            if( literal.isNull() )
+            {
+                endRun();
+                i = next;
+                continue;
+            }
+
+            // a quantifier after the character makes it optional, or required only once.
+            // Counted quantifiers are skipped on the next iteration
+            const QChar quantifier( next < size ? pattern[next] : QChar() );
+            if( quantifier == QLatin1Char( '?' ) || quantifier == QLatin1Char( '*' ) || quantifier == QLatin1Char( '{' ) )
+            {
+                endRun();
+            } else if( quantifier == QLatin1Char( '+' ) ) {
+                run.append( literal );
+                endRun();
+            } else run.append( literal );
+
+            i = next;
+
+        }
+
+        endRun();
+        return best;
+
+    }
+
+}
@@ -0,0 +1,122 @@
+#ifndef breezeexceptionmatcher_h
+#define breezeexceptionmatcher_h
+
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breeze.h"
+
+#include <QHash>
+#include <QList>
+#include <QRegularExpression>
+#include <QSet>
+#include <QString>
+
+namespace SierraBreeze
+{
+
+    //* first-match lookup of the exception that applies to a window
+    /**
+    literal patterns are looked up in hash tables. Regular expressions and globs are scanned in priority order,
+    only up to the best literal match, and regular expressions are skipped without running them when
+    the window property does not contain a substring that any match requires.
+    Class name patterns are matched against the string formed by the resource name and class, separated by a space.
+    Literals and globs must match the resource name or the resource class exactly.
+    */
+    class ExceptionMatcher
+    {
+
+        public:
+
+        //* rebuild from exceptions, in priority order. Exceptions at ignored indices never match
+        void build( const InternalSettingsList&, const QSet<int>& ignored = QSet<int>() );
+
+        //* true if some exception of given type may match, so that the corresponding property is needed
+        bool uses( int exceptionType ) const
+        { return m_uses[ exceptionType == InternalSettings::ExceptionWindowTitle ]; }
+
+        //* index of the first exception matching a window, -1 if none
+        int match( const QString& className, const QString& title ) const;
+
+        //* true if exception at given index matches a window
+        bool matches( int index, const QString& className, const QString& title ) const;
+
+        //* indices of the exceptions refused since last call, because their matches kept going over budget
+        QList<int> takeRefused( void ) const;
+
+        //* consecutive over budget matches after which an exception is refused
+        static constexpr int RefusalStrikes = 3;
+
+        //* equivalent regular expression of a pattern of given kind
+        static QString regularExpression( const QString& pattern, int patternKind );
+
+        //* a substring every match of a regular expression contains, empty if none could be found
+        static QString requiredLiteral( const QString& pattern );
+
+        private:
+
+        //* compiled exception
+        struct Rule
+        {
+            //* false for disabled, empty, invalid or ignored exceptions
+            bool active = false;
+
+            //* exception type
+            int type = InternalSettings::ExceptionWindowClassName;
+
+            //* pattern kind
+            int kind = InternalSettings::PatternRegExp;
+
+            //* literal, or substring required by the expression
+            QString literal;
+
+            //* compiled expression, for regular expressions and globs
+            QRegularExpression expression;
+
+            //* consecutive matches that went over budget
+            mutable int strikes = 0;
+
+            //* set when too many consecutive matches went over budget. The rule is ignored from then on
+            mutable bool refused = false;
+        };
+
+        //* all rules, indexed as the exceptions
+        QList<Rule> m_rules;
+
+        //* indices of the rules that need scanning, in priority order
+        QList<int> m_scanned;
+
+        //* first literal rule for a given resource name or class
+        QHash<QString, int> m_classLiterals;
+
+        //* first literal rule for a given title
+        QHash<QString, int> m_titleLiterals;
+
+        //* whether class name and title rules exist
+        bool m_uses[2] = { false, false };
+
+        //* rules refused since last call to takeRefused
+        mutable QList<int> m_refused;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breezeglyphregistry.h"
+#include "breezetracing.h"
+
+#include <QDir>
+#include <QFile>
+#include <QPainter>
+#include <QPainterPathStroker>
+#include <QStandardPaths>
+#include <QSvgRenderer>
+
+namespace SierraBreeze
+{
+
+    //__________________________________________________________________
+    GlyphRegistry& GlyphRegistry::self( void )
+    {
+        static GlyphRegistry registry;
+        return registry;
+    }
+
+    //__________________________________________________________________
+    GlyphRegistry::GlyphRegistry( void ):
+        m_images( 2048 ),
+        m_paths( 64 )
+    {}
+
+    //__________________________________________________________________
+    bool GlyphRegistry::setGlyphSet( const QString& name )
+    {
+        if( name == m_glyphSet ) return false;
+        BREEZE_TRACE_SCOPE( "GlyphRegistry::setGlyphSet" );
+
+        m_glyphSet = name;
+        m_renderers.clear();
+        m_images.clear();
+        if( name.isEmpty() ) return true;
+
+        const QString path( QStandardPaths::locate( QStandardPaths::GenericDataLocation, QStringLiteral( "sierrabreeze/glyphs/" ) + name, QStandardPaths::LocateDirectory ) );
+        if( path.isEmpty() ) return true;
+
+        const QDir directory( path );
+        for( int glyph = NoGlyph + 1; glyph < GlyphCount; ++glyph )
+        {
+            const QString file( directory.filePath( QString::fromLatin1( glyphs[glyph].name ) + QStringLiteral( ".svg" ) ) );
+            if( !QFile::exists( file ) ) continue;
+
+            QSharedPointer<QSvgRenderer> renderer( new QSvgRenderer( file ) );
+            if( renderer->isValid() ) m_renderers.insert( glyph, renderer );
+        }
+
+        return true;
+    }
+
+    //__________________________________________________________________
+    const QImage* GlyphRegistry::svgImage( Glyph glyph, const QSize& size )
+    {
+        const auto renderer( m_renderers.value( glyph ) );
+        if( !renderer || size.isEmpty() ) return nullptr;
+
+        const quint64 key( ( quint64( glyph ) << 32 ) | ( quint64( size.width() ) << 16 ) | quint64( size.height() ) );
+        if( const QImage* image = m_images.object( key ) ) return image;
+
+        BREEZE_TRACE_SCOPE( "GlyphRegistry::svgImage" );
+        auto image = new QImage( size, QImage::Format_ARGB32_Premultiplied );
+        image->fill( Qt::transparent );
+
+        QPainter painter( image );
+        painter.setRenderHints( QPainter::Antialiasing|QPainter::SmoothPixmapTransform );
+        renderer->render( &painter, QRectF( QPointF( 0, 0 ), size ) );
+        painter.end();
+
+        const int cost( qMax<qsizetype>( 1, image->sizeInBytes()/1024 ) );
+        return m_images.insert( key, image, cost ) ? m_images.object( key ) : nullptr;
+    }
+
+    //__________________________________________________________________
+    const QPainterPath& GlyphRegistry::path( Glyph glyph, qreal strokeWidth )
+    {
+        const GlyphDefinition& definition( glyphs[glyph] );
+
+        // fills do not depend on the stroke width
+        const QPair<int, qreal> key( glyph, definition.stroked ? strokeWidth : 0 );
+        if( const QPainterPath* path = m_paths.object( key ) ) return *path;
+
+        BREEZE_TRACE_SCOPE( "GlyphRegistry::path" );
+        QPainterPath outline;
+        QPainterPath centerLine;
+        for( int index = definition.first; index < definition.first + definition.count; ++index )
+        {
+            const GlyphPrimitive& primitive( primitives[index] );
+            const float* v( primitive.values );
+            switch( primitive.type )
+            {
+                case GlyphPrimitive::Line:
+                centerLine.moveTo( v[0], v[1] );
+                centerLine.lineTo( v[2], v[3] );
+                break;
+
+                case GlyphPrimitive::Polyline:
+                centerLine.moveTo( v[0], v[1] );
+                centerLine.lineTo( v[2], v[3] );
+                centerLine.lineTo( v[4], v[5] );
+                break;
+
+                case GlyphPrimitive::Triangle:
+                outline.moveTo( v[0], v[1] );
+                outline.lineTo( v[2], v[3] );
+                outline.lineTo( v[4], v[5] );
+                outline.closeSubpath();
+                break;
+
+                case GlyphPrimitive::Disk:
+                outline.addEllipse( QPointF( v[0], v[1] ), v[2], v[2] );
+                break;
+            }
+        }
+
+        if( !centerLine.isEmpty() )
+        {
+            // same pen as the hover hints
+            QPainterPathStroker stroker;
+            stroker.setWidth( strokeWidth );
+            stroker.setCapStyle( Qt::RoundCap );
+            stroker.setJoinStyle( Qt::MiterJoin );
+            outline.addPath( stroker.createStroke( centerLine ) );
+        }
+
+        outline.setFillRule( Qt::WindingFill );
+        auto path = new QPainterPath( outline );
+        m_paths.insert( key, path );
+        return *path;
+    }
+
+}
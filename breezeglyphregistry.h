@@ -0,0 +1,175 @@
+#ifndef breezeglyphregistry_h
+#define breezeglyphregistry_h
+
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QPainterPath>
+#include <QSharedPointer>
+#include <QString>
+
+class QSvgRenderer;
+
+namespace SierraBreeze
+{
+
+    //* drawing primitive of a button mark, in icon coordinates
+    struct GlyphPrimitive
+    {
+        enum Type
+        {
+            Line,
+            Polyline,
+            Triangle,
+            Disk
+        };
+
+        Type type;
+
+        //* line: two points, polyline and triangle: three points, disk: center and radius
+        float values[6];
+    };
+
+    //* button mark, as a range of the primitive table
+    struct GlyphDefinition
+    {
+        //* name, also used for SVG file names
+        const char* name;
+
+        //* first primitive and primitive count
+        int first;
+        int count;
+
+        //* true if primitives are stroked with the hint pen, false if filled
+        bool stroked;
+    };
+
+    //* button marks
+    /**
+    the built-in marks are described by a constant table of primitives, from which the distance fields,
+    and the painter paths used when drawing with QPainter, are generated.
+    Marks can be overridden by SVG glyph sets, installed as sierrabreeze/glyphs/<set>/<name>.svg
+    in the generic data location and selected with the GlyphSet option.
+    */
+    class GlyphRegistry
+    {
+
+        public:
+
+        //* glyphs
+        enum Glyph
+        {
+            NoGlyph,
+            Cross,
+            MaximizeTriangles,
+            MinimizeLine,
+            CenterDot,
+            ShadeUp,
+            ShadeDown,
+            ArrowDown,
+            ArrowUp,
+            GlyphCount
+        };
+
+        //* primitives
+        static constexpr GlyphPrimitive primitives[] =
+        {
+            // cross
+            { GlyphPrimitive::Line, { 6, 6, 12, 12 } },
+            { GlyphPrimitive::Line, { 6, 12, 12, 6 } },
+
+            // maximize triangles
+            { GlyphPrimitive::Triangle, { 5, 13, 11, 13, 5, 7 } },
+            { GlyphPrimitive::Triangle, { 13, 5, 7, 5, 13, 11 } },
+
+            // minimize line
+            { GlyphPrimitive::Line, { 5, 9, 13, 9 } },
+
+            // center dot
+            { GlyphPrimitive::Disk, { 9, 9, 3 } },
+
+            // shade
+            { GlyphPrimitive::Line, { 4, 5, 14, 5 } },
+            { GlyphPrimitive::Polyline, { 4, 13, 9, 8, 14, 13 } },
+
+            // unshade
+            { GlyphPrimitive::Line, { 4, 5, 14, 5 } },
+            { GlyphPrimitive::Polyline, { 4, 8, 9, 13, 14, 8 } },
+
+            // arrows
+            { GlyphPrimitive::Triangle, { 9, 12, 5, 6, 13, 6 } },
+            { GlyphPrimitive::Triangle, { 9, 6, 5, 12, 13, 12 } }
+        };
+
+        //* glyphs, indexed by Glyph
+        static constexpr GlyphDefinition glyphs[GlyphCount] =
+        {
+            { "", 0, 0, false },
+            { "close", 0, 2, true },
+            { "maximize", 2, 2, false },
+            { "minimize", 4, 1, true },
+            { "on-all-desktops", 5, 1, false },
+            { "shade", 6, 2, true },
+            { "unshade", 8, 2, true },
+            { "keep-below", 10, 1, false },
+            { "keep-above", 11, 1, false }
+        };
+
+        //* shared registry
+        static GlyphRegistry& self( void );
+
+        //* select SVG glyph set. Empty name selects the built-in marks. Returns true if changed
+        bool setGlyphSet( const QString& );
+
+        //* true if the selected glyph set overrides glyph
+        bool hasSvg( Glyph glyph ) const
+        { return m_renderers.contains( glyph ); }
+
+        //* glyph from the selected glyph set, rasterized for a QRect( 0, 0, 18, 18 ) icon box of given size in pixels
+        const QImage* svgImage( Glyph, const QSize& );
+
+        //* filled outline of a built-in glyph, in icon coordinates. Built once per stroke width
+        const QPainterPath& path( Glyph, qreal strokeWidth );
+
+        private:
+
+        //* constructor
+        GlyphRegistry( void );
+
+        //* selected glyph set
+        QString m_glyphSet;
+
+        //* renderers of the selected glyph set
+        QHash<int, QSharedPointer<QSvgRenderer>> m_renderers;
+
+        //* SVG rasterizations
+        QCache<quint64, QImage> m_images;
+
+        //* outlines
+        QCache<QPair<int, qreal>, QPainterPath> m_paths;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,210 @@
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breezeglyphset.h"
+#include "breezerasterizer.h"
+#include "breezetracing.h"
+
+#include <cmath>
+
+namespace SierraBreeze
+{
+
+    namespace
+    {
+
+        //* grid covers icon coordinates -1 to 19
+        constexpr float s_fieldOrigin = -1;
+        constexpr float s_fieldSize = 20;
+
+        //* primitive distance functions, in icon coordinates
+        float length( float x, float y )
+        { return std::sqrt( x*x + y*y ); }
+
+        //* distance to a segment
+        float segmentDistance( const QPointF& p, const QPointF& a, const QPointF& b )
+        {
+            const QPointF ab( b - a );
+            const QPointF ap( p - a );
+            const qreal t( qBound<qreal>( 0, QPointF::dotProduct( ap, ab )/QPointF::dotProduct( ab, ab ), 1 ) );
+            const QPointF d( ap - ab*t );
+            return length( d.x(), d.y() );
+        }
+
+        //* distance to the infinite line through a and b
+        float lineDistance( const QPointF& p, const QPointF& a, const QPointF& b )
+        {
+            const QPointF ab( b - a );
+            const QPointF ap( p - a );
+            return std::abs( ab.x()*ap.y() - ab.y()*ap.x() )/length( ab.x(), ab.y() );
+        }
+
+        //* distance to a polyline stroked with miter joins
+        /**
+        outside of each joint the stroke boundary is the intersection of the two offset lines,
+        rather than the circle given by the distance to the segments
+        */
+        float polylineDistance( const QPointF& p, const QPointF* points, int count )
+        {
+            float out( segmentDistance( p, points[0], points[1] ) );
+            for( int i = 1; i < count - 1; ++i )
+            {
+                const QPointF& a( points[i-1] );
+                const QPointF& b( points[i] );
+                const QPointF& c( points[i+1] );
+                out = std::min( out, segmentDistance( p, b, c ) );
+
+                // outer sector of the joint: past b along ab, and before b along bc
+                if( QPointF::dotProduct( p - b, b - a ) > 0 && QPointF::dotProduct( p - b, c - b ) < 0 )
+                { out = std::min( out, std::max( lineDistance( p, a, b ), lineDistance( p, b, c ) ) ); }
+            }
+
+            return out;
+        }
+
+        //* signed distance to a triangle, negative inside
+        float triangleDistance( const QPointF& p, const QPointF& a, const QPointF& b, const QPointF& c )
+        {
+            const float out( std::min( { segmentDistance( p, a, b ), segmentDistance( p, b, c ), segmentDistance( p, c, a ) } ) );
+
+            auto side = []( const QPointF& p, const QPointF& a, const QPointF& b )
+            { return ( b.x() - a.x() )*( p.y() - a.y() ) - ( b.y() - a.y() )*( p.x() - a.x() ); };
+
+            const qreal s0( side( p, a, b ) );
+            const qreal s1( side( p, b, c ) );
+            const qreal s2( side( p, c, a ) );
+            const bool inside( ( s0 >= 0 && s1 >= 0 && s2 >= 0 ) || ( s0 <= 0 && s1 <= 0 && s2 <= 0 ) );
+            return inside ? -out : out;
+        }
+
+        //* signed distance to a disk, negative inside
+        float diskDistance( const QPointF& p, const QPointF& center, qreal radius )
+        {
+            const QPointF d( p - center );
+            return length( d.x(), d.y() ) - radius;
+        }
+
+        //* distance to a glyph, at icon coordinates p
+        float glyphDistance( GlyphRegistry::Glyph glyph, const QPointF& p )
+        {
+            const GlyphDefinition& definition( GlyphRegistry::glyphs[glyph] );
+
+            float out( s_fieldSize );
+            for( int index = definition.first; index < definition.first + definition.count; ++index )
+            {
+                const GlyphPrimitive& primitive( GlyphRegistry::primitives[index] );
+                const float* v( primitive.values );
+                switch( primitive.type )
+                {
+                    case GlyphPrimitive::Line:
+                    out = std::min( out, segmentDistance( p, QPointF( v[0], v[1] ), QPointF( v[2], v[3] ) ) );
+                    break;
+
+                    case GlyphPrimitive::Polyline:
+                    {
+                        const QPointF points[] = { QPointF( v[0], v[1] ), QPointF( v[2], v[3] ), QPointF( v[4], v[5] ) };
+                        out = std::min( out, polylineDistance( p, points, 3 ) );
+                        break;
+                    }
+
+                    case GlyphPrimitive::Triangle:
+                    out = std::min( out, triangleDistance( p, QPointF( v[0], v[1] ), QPointF( v[2], v[3] ), QPointF( v[4], v[5] ) ) );
+                    break;
+
+                    case GlyphPrimitive::Disk:
+                    out = std::min( out, diskDistance( p, QPointF( v[0], v[1] ), v[2] ) );
+                    break;
+                }
+            }
+
+            return out;
+        }
+
+    }
+
+    //__________________________________________________________________
+    const GlyphSet& GlyphSet::self( void )
+    {
+        static const GlyphSet glyphSet;
+        return glyphSet;
+    }
+
+    //__________________________________________________________________
+    GlyphSet::GlyphSet( void )
+    {
+        BREEZE_TRACE_SCOPE( "GlyphSet::GlyphSet" );
+
+        const float step( s_fieldSize/Resolution );
+        for( int glyph = GlyphRegistry::NoGlyph + 1; glyph < GlyphRegistry::GlyphCount; ++glyph )
+        {
+            auto& field( m_fields[glyph] );
+            field.resize( Resolution*Resolution );
+            for( int j = 0; j < Resolution; ++j )
+            {
+                for( int i = 0; i < Resolution; ++i )
+                {
+                    const QPointF p( s_fieldOrigin + ( i + 0.5 )*step, s_fieldOrigin + ( j + 0.5 )*step );
+                    field[i + j*Resolution] = glyphDistance( Glyph( glyph ), p );
+                }
+            }
+        }
+    }
+
+    //__________________________________________________________________
+    float GlyphSet::distance( Glyph glyph, float x, float y ) const
+    {
+
+        // continuous sample coordinates, clamped to the grid
+        const float step( s_fieldSize/Resolution );
+        const float u( qBound<float>( 0, ( x - s_fieldOrigin )/step - 0.5f, Resolution - 1 ) );
+        const float v( qBound<float>( 0, ( y - s_fieldOrigin )/step - 0.5f, Resolution - 1 ) );
+
+        const int i( qMin( int( u ), Resolution - 2 ) );
+        const int j( qMin( int( v ), Resolution - 2 ) );
+        const float fu( u - i );
+        const float fv( v - j );
+
+        // bilinear interpolation
+        const float* field( m_fields[glyph].constData() + i + j*Resolution );
+        const float top( field[0] + ( field[1] - field[0] )*fu );
+        const float bottom( field[Resolution] + ( field[Resolution + 1] - field[Resolution] )*fu );
+        return top + ( bottom - top )*fv;
+
+    }
+
+    //__________________________________________________________________
+    void GlyphSet::render( QImage& image, Glyph glyph, const QPointF& origin, qreal scale, qreal strokeWidth, const QColor& color ) const
+    {
+        if( glyph <= GlyphRegistry::NoGlyph || glyph >= GlyphRegistry::GlyphCount ) return;
+        BREEZE_TRACE_SCOPE( "GlyphSet::render" );
+
+        const float x0( origin.x() );
+        const float y0( origin.y() );
+        const float unit( scale );
+        const float offset( GlyphRegistry::glyphs[glyph].stroked ? strokeWidth/2 : 0 );
+
+        // marks are drawn inside QRect( 0, 0, 18, 18 ) in icon coordinates
+        const QRectF bounds( origin, QSizeF( 18, 18 )*scale );
+        Rasterizer::fill( image, bounds, color,
+            [this, glyph, x0, y0, unit, offset]( float x, float y )
+            { return ( distance( glyph, ( x - x0 )/unit, ( y - y0 )/unit ) - offset )*unit; } );
+    }
+
+}
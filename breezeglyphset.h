@@ -0,0 +1,77 @@
+#ifndef breezeglyphset_h
+#define breezeglyphset_h
+
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breezeglyphregistry.h"
+
+#include <QColor>
+#include <QImage>
+#include <QPointF>
+#include <QVector>
+
+namespace SierraBreeze
+{
+
+    //* built-in button marks, stored as distance fields
+    /**
+    fields are generated once from the primitives of the GlyphRegistry, on a fixed grid covering the icon coordinates QRect( -1, -1, 20, 20 ).
+    Rendering at any icon size, scale and color is a per pixel threshold of the interpolated distance,
+    so that new sizes never require the marks to be rasterized again.
+    Stroked marks store the distance to their center line, the stroke width being applied when rendering.
+    */
+    class GlyphSet
+    {
+
+        public:
+
+        //* glyphs
+        using Glyph = GlyphRegistry::Glyph;
+
+        //* shared glyph set, generated on first use
+        static const GlyphSet& self( void );
+
+        //* render glyph into image
+        /**
+        origin is the position of icon coordinates ( 0, 0 ) in image pixels, and scale the size of an icon unit in image pixels.
+        strokeWidth is in icon units and ignored for filled glyphs
+        */
+        void render( QImage&, Glyph, const QPointF& origin, qreal scale, qreal strokeWidth, const QColor& ) const;
+
+        private:
+
+        //* constructor
+        GlyphSet( void );
+
+        //* interpolated distance at given icon coordinates
+        float distance( Glyph, float x, float y ) const;
+
+        //* number of samples along each axis
+        static constexpr int Resolution = 64;
+
+        //* distance fields
+        QVector<float> m_fields[GlyphRegistry::GlyphCount];
+
+    };
+
+}
+
+#endif
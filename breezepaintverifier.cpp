@@ -0,0 +1,136 @@
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breezepaintverifier.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QPainter>
+
+namespace SierraBreeze
+{
+
+    bool PaintVerifier::s_referencePass = false;
+    bool PaintVerifier::s_verifying = false;
+
+    //__________________________________________________________________
+    int PaintVerifier::tolerance( void )
+    {
+        bool ok( false );
+        const int value( qEnvironmentVariableIntValue( "SIERRABREEZE_VERIFY_TOLERANCE", &ok ) );
+        return ok ? value : 2;
+    }
+
+    //__________________________________________________________________
+    bool PaintVerifier::verify( const QString& name, const QSize& size, qreal devicePixelRatio, const PaintFunction& function )
+    {
+
+        if( s_verifying || size.isEmpty() ) return true;
+
+        // optimized pass first, so that it sees the caches as left by the previous paint
+        const QImage optimized( render( size, devicePixelRatio, function, false ) );
+        const QImage reference( render( size, devicePixelRatio, function, true ) );
+
+        int mismatches( 0 );
+        const int difference( compare( reference, optimized, tolerance(), &mismatches ) );
+        if( !mismatches ) return true;
+
+        qWarning().nospace() << "SierraBreeze: optimized rendering of " << name
+            << " differs from reference: " << mismatches << " pixels, max channel difference " << difference
+            << " (size " << size << ", scale " << devicePixelRatio << ")";
+
+        save( name, reference, optimized );
+        return false;
+
+    }
+
+    //__________________________________________________________________
+    int PaintVerifier::compare( const QImage& first, const QImage& second, int tolerance, int* mismatches )
+    {
+
+        if( mismatches ) *mismatches = 0;
+
+        if( first.size() != second.size() )
+        {
+            if( mismatches ) *mismatches = qMax( first.width()*first.height(), second.width()*second.height() );
+            return 255;
+        }
+
+        const QImage a( first.convertToFormat( QImage::Format_ARGB32_Premultiplied ) );
+        const QImage b( second.convertToFormat( QImage::Format_ARGB32_Premultiplied ) );
+
+        int maxDifference( 0 );
+        for( int y = 0; y < a.height(); ++y )
+        {
+            const QRgb* lineA = reinterpret_cast<const QRgb*>( a.constScanLine( y ) );
+            const QRgb* lineB = reinterpret_cast<const QRgb*>( b.constScanLine( y ) );
+            for( int x = 0; x < a.width(); ++x )
+            {
+                const int difference = qMax(
+                    qMax( qAbs( qRed( lineA[x] ) - qRed( lineB[x] ) ), qAbs( qGreen( lineA[x] ) - qGreen( lineB[x] ) ) ),
+                    qMax( qAbs( qBlue( lineA[x] ) - qBlue( lineB[x] ) ), qAbs( qAlpha( lineA[x] ) - qAlpha( lineB[x] ) ) ) );
+
+                maxDifference = qMax( maxDifference, difference );
+                if( difference > tolerance && mismatches ) ++*mismatches;
+            }
+        }
+
+        return maxDifference;
+
+    }
+
+    //__________________________________________________________________
+    QImage PaintVerifier::render( const QSize& size, qreal devicePixelRatio, const PaintFunction& function, bool reference )
+    {
+
+        QImage image( size*devicePixelRatio, QImage::Format_ARGB32_Premultiplied );
+        image.setDevicePixelRatio( devicePixelRatio );
+        image.fill( Qt::transparent );
+
+        const bool verifying( s_verifying );
+        s_verifying = true;
+        s_referencePass = reference;
+
+        QPainter painter( &image );
+        function( &painter );
+        painter.end();
+
+        s_referencePass = false;
+        s_verifying = verifying;
+        return image;
+
+    }
+
+    //__________________________________________________________________
+    void PaintVerifier::save( const QString& name, const QImage& reference, const QImage& optimized )
+    {
+
+        const QString path( qEnvironmentVariable( "SIERRABREEZE_VERIFY_DIR" ) );
+        if( path.isEmpty() ) return;
+
+        static int index( 0 );
+        const QDir directory( path );
+        const QString baseName( QStringLiteral( "%1-%2" ).arg( name ).arg( index++, 4, 10, QLatin1Char( '0' ) ) );
+        reference.save( directory.filePath( baseName + QStringLiteral( "-reference.png" ) ) );
+        optimized.save( directory.filePath( baseName + QStringLiteral( "-optimized.png" ) ) );
+
+    }
+
+}
@@ -0,0 +1,100 @@
+#ifndef breezepaintverifier_h
+#define breezepaintverifier_h
+
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config-breeze.h"
+
+#if SIERRABREEZE_PAINT_VERIFICATION
+
+#include <QImage>
+#include <QSize>
+
+#include <functional>
+
+class QPainter;
+
+namespace SierraBreeze
+{
+
+    //* pixel comparison between the reference and the optimized paint paths
+    /**
+    every optimized (cached or fast-path) rendering keeps the plain QPainter code it replaces,
+    selected when BREEZE_REFERENCE_PAINT is true. In verification builds, painting is done twice
+    offscreen, once through each path, and the two images are compared. The optimized pass comes first,
+    and the reference pass must neither read nor write the caches, so that stale cache entries show up.
+
+    Environment variables:
+    SIERRABREEZE_VERIFY_TOLERANCE: max per-channel difference, default 2
+    SIERRABREEZE_VERIFY_DIR: directory in which mismatching images are saved as PNG
+    */
+    class PaintVerifier
+    {
+
+        public:
+
+        //* paint function
+        using PaintFunction = std::function<void(QPainter*)>;
+
+        //* true while rendering the reference pass
+        static bool isReferencePass( void )
+        { return s_referencePass; }
+
+        //* true while a verification is running
+        static bool isVerifying( void )
+        { return s_verifying; }
+
+        //* render reference and optimized passes and compare. Returns true if they match
+        static bool verify( const QString& name, const QSize& size, qreal devicePixelRatio, const PaintFunction& );
+
+        //* max per-channel difference between two images. Number of differing pixels is stored in the last argument
+        static int compare( const QImage&, const QImage&, int tolerance, int* mismatches = nullptr );
+
+        //* max per-channel difference allowed by verify, from SIERRABREEZE_VERIFY_TOLERANCE
+        static int tolerance( void );
+
+        //* render one pass. Verifications requested while painting are skipped
+        static QImage render( const QSize&, qreal devicePixelRatio, const PaintFunction&, bool reference );
+
+        private:
+
+        //* save mismatching images
+        static void save( const QString& name, const QImage& reference, const QImage& optimized );
+
+        //* reference pass
+        static bool s_referencePass;
+
+        //* verification running
+        static bool s_verifying;
+
+    };
+
+}
+
+#define BREEZE_REFERENCE_PAINT SierraBreeze::PaintVerifier::isReferencePass()
+
+#else
+
+#define BREEZE_REFERENCE_PAINT false
+
+#endif
+
+#endif
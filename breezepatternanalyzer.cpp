@@ -0,0 +1,335 @@
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breezepatternanalyzer.h"
+#include "breezesettings.h"
+
+#include <QList>
+#include <QRegularExpression>
+#include <QStringList>
+
+#include <ctime>
+#include <limits>
+
+namespace SierraBreeze
+{
+
+    namespace
+    {
+
+        //* class names, as matched by the decoration: resource name and resource class
+        const QStringList& classNames( void )
+        {
+            static const QStringList corpus =
+            {
+                QStringLiteral( "konsole org.kde.konsole" ),
+                QStringLiteral( "dolphin org.kde.dolphin" ),
+                QStringLiteral( "kate org.kde.kate" ),
+                QStringLiteral( "systemsettings systemsettings" ),
+                QStringLiteral( "plasmashell org.kde.plasmashell" ),
+                QStringLiteral( "navigator firefox" ),
+                QStringLiteral( "chromium-browser Chromium-browser" ),
+                QStringLiteral( "code Code" ),
+                QStringLiteral( "libreoffice-writer libreoffice-writer" ),
+                QStringLiteral( "gimp-2.10 Gimp-2.10" ),
+                QStringLiteral( "steam_app_1091500 steam_app_1091500" ),
+                QStringLiteral( "jetbrains-idea jetbrains-idea" ),
+                QStringLiteral( "org.gnome.Nautilus org.gnome.Nautilus" ),
+                QStringLiteral( "xterm XTerm" ),
+                QStringLiteral( "sun-awt-X11-XFramePeer com-install4j-runtime-launcher-UnixLauncher" ),
+                QStringLiteral( "crx_hnpfjngllnobngcgfapefoaidbinmjnm Google-chrome" )
+            };
+            return corpus;
+        }
+
+        //* window titles
+        const QStringList& titles( void )
+        {
+            static const QStringList corpus =
+            {
+                QStringLiteral( "~ : bash — Konsole" ),
+                QStringLiteral( "Home — Dolphin" ),
+                QStringLiteral( "breezedecoration.cpp — sierrabreeze — Kate" ),
+                QStringLiteral( "Picture-in-Picture" ),
+                QStringLiteral( "Inbox (1,204) - user@example.org - Mail" ),
+                QStringLiteral( "Window Decorations — System Settings" ),
+                QStringLiteral( "Untitled 1 - LibreOffice Writer" ),
+                QStringLiteral( "[main] ~/src/project/src/components/layout/Sidebar.tsx - project - Visual Studio Code" ),
+                QStringLiteral( "Building... ==================================================>      93%" ),
+                QStringLiteral( "Downloading....................................................................." ),
+                QStringLiteral( "How to stop catastrophic backtracking in regular expressions? - Stack Overflow — Mozilla Firefox" ),
+                QStringLiteral( "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa" ),
+                QStringLiteral( "" )
+            };
+            return corpus;
+        }
+
+        //* group being parsed
+        struct Frame
+        {
+            //* group contains an unbounded quantifier
+            bool unbounded = false;
+
+            //* group has several alternatives
+            bool alternation = false;
+
+            //* current alternative has a first atom
+            bool started = false;
+
+            //* first atom of each alternative
+            QStringList starts;
+        };
+
+        //* true if two alternatives may match the same text. Conservative on what it cannot tell
+        bool overlaps( const QStringList& starts )
+        {
+            for( int index = 0; index < starts.size(); ++index )
+            {
+                const QString& start( starts[index] );
+                if( start.isEmpty() || start == QLatin1String( "." ) ) return true;
+                if( starts.indexOf( start, index+1 ) >= 0 ) return true;
+            }
+            return false;
+        }
+
+    }
+
+    //__________________________________________________________________
+    int PatternAnalyzer::hazards( const QString& pattern )
+    {
+
+        int out( NoHazard );
+        QList<Frame> stack( 1 );
+
+        // position right after the last quantified wildcard
+        int wildcardEnd( -1 );
+
+        const int size( pattern.size() );
+        for( int i = 0; i < size; )
+        {
+
+            const int atomStart( i );
+            const QChar c( pattern[i] );
+
+            QString atom;
+            bool isGroup( false );
+            Frame closed;
+
+            if( c == QLatin1Char( '\\' ) )
+            {
+
+                if( i+1 < size )
+                {
+                    const QChar next( pattern[i+1] );
+                    if( ( next.isDigit() && next != QLatin1Char( '0' ) ) || next == QLatin1Char( 'k' ) || next == QLatin1Char( 'g' ) )
+                    { out |= BackReference; }
+                }
+
+                atom = pattern.mid( i, 2 );
+                i += 2;
+
+            } else if( c == QLatin1Char( '[' ) ) {
+
+                // character class, up to the matching bracket
+                int end( i+1 );
+                if( end < size && pattern[end] == QLatin1Char( '^' ) ) ++end;
+                if( end < size && pattern[end] == QLatin1Char( ']' ) ) ++end;
+                for( ; end < size && pattern[end] != QLatin1Char( ']' ); ++end )
+                { if( pattern[end] == QLatin1Char( '\\' ) ) ++end; }
+
+                atom = pattern.mid( i, end - i + 1 );
+                i = end + 1;
+
+            } else if( c == QLatin1Char( '(' ) ) {
+
+                ++i;
+
+                // skip group modifiers: non capturing, look around, named groups and inline options
+                if( i < size && pattern[i] == QLatin1Char( '?' ) )
+                {
+                    static const QRegularExpression modifiers( QStringLiteral( "[:=!>')]" ) );
+                    const int end( pattern.indexOf( modifiers, i+1 ) );
+                    if( end < 0 ) break;
+                    i = end + 1;
+
+                    // inline options alone, as in (?i), open no group
+                    if( pattern[end] == QLatin1Char( ')' ) ) continue;
+                }
+
+                stack.append( Frame() );
+                continue;
+
+            } else if( c == QLatin1Char( '|' ) ) {
+
+                auto& frame( stack.last() );
+                if( !frame.started ) frame.starts.append( QString() );
+                frame.alternation = true;
+                frame.started = false;
+                ++i;
+                continue;
+
+            } else if( c == QLatin1Char( ')' ) ) {
+
+                ++i;
+                if( stack.size() > 1 )
+                {
+                    closed = stack.takeLast();
+                    if( closed.alternation && !closed.started ) closed.starts.append( QString() );
+                    isGroup = true;
+                    atom = QStringLiteral( "(" );
+                }
+
+            } else {
+
+                atom = c;
+                ++i;
+
+            }
+
+            // first atom of the current alternative
+            auto& frame( stack.last() );
+            if( !frame.started )
+            {
+                frame.starts.append( atom );
+                frame.started = true;
+            }
+
+            // quantifier
+            bool unbounded( false );
+            bool quantified( false );
+            if( i < size )
+            {
+
+                const QChar q( pattern[i] );
+                if( q == QLatin1Char( '*' ) || q == QLatin1Char( '+' ) )
+                {
+
+                    quantified = unbounded = true;
+                    ++i;
+
+                } else if( q == QLatin1Char( '?' ) ) {
+
+                    quantified = true;
+                    ++i;
+
+                } else if( q == QLatin1Char( '{' ) ) {
+
+                    static const QRegularExpression repetition( QStringLiteral( "\\{\\d*(,\\d*)?\\}" ) );
+                    const QRegularExpressionMatch match( repetition.match( pattern, i, QRegularExpression::NormalMatch, QRegularExpression::AnchorAtOffsetMatchOption ) );
+                    if( match.hasMatch() )
+                    {
+                        quantified = true;
+                        unbounded = match.captured().endsWith( QLatin1String( ",}" ) );
+                        i = match.capturedEnd();
+                    }
+
+                }
+
+                // lazy quantifiers still backtrack, possessive ones do not
+                if( quantified && i < size && pattern[i] == QLatin1Char( '+' ) )
+                {
+                    unbounded = false;
+                    ++i;
+                } else if( quantified && i < size && pattern[i] == QLatin1Char( '?' ) ) ++i;
+
+            }
+
+            if( isGroup )
+            {
+
+                if( unbounded && closed.unbounded ) out |= NestedQuantifier;
+                if( unbounded && closed.alternation && overlaps( closed.starts ) ) out |= OverlappingAlternation;
+                frame.unbounded |= closed.unbounded || unbounded;
+
+            } else if( unbounded ) {
+
+                frame.unbounded = true;
+
+                if( atom == QLatin1String( "." ) )
+                {
+                    if( wildcardEnd == atomStart ) out |= AdjacentWildcards;
+                    wildcardEnd = i;
+                }
+
+            }
+
+        }
+
+        return out;
+
+    }
+
+    //__________________________________________________________________
+    qint64 PatternAnalyzer::threadTime( void )
+    {
+        timespec time;
+        clock_gettime( CLOCK_THREAD_CPUTIME_ID, &time );
+        return qint64( time.tv_sec )*1000000000 + time.tv_nsec;
+    }
+
+    //__________________________________________________________________
+    const QStringList& PatternAnalyzer::corpus( int exceptionType )
+    { return exceptionType == InternalSettings::ExceptionWindowTitle ? titles() : classNames(); }
+
+    //__________________________________________________________________
+    PatternAnalyzer::Report PatternAnalyzer::analyze( const QString& pattern, int exceptionType )
+    {
+
+        Report report;
+
+        QRegularExpression expression( pattern );
+        if( !expression.isValid() )
+        {
+            report.error = expression.errorString();
+            return report;
+        }
+
+        report.valid = true;
+        report.hazards = hazards( pattern );
+
+        // compile now, so that compilation is not accounted in the first match
+        expression.optimize();
+
+        const QStringList& corpus( PatternAnalyzer::corpus( exceptionType ) );
+
+        qint64 total( 0 );
+        for( const QString& value : corpus )
+        {
+
+            // best of a few runs, to filter out scheduling noise. Stop early on expensive matches
+            qint64 best( std::numeric_limits<qint64>::max() );
+            for( int run = 0; run < 3 && best <= WorstCaseBudget; ++run )
+            {
+                const qint64 start( threadTime() );
+                expression.match( value ).hasMatch();
+                best = qMin( best, threadTime() - start );
+            }
+
+            total += best;
+            report.worstCost = qMax( report.worstCost, best );
+
+        }
+
+        report.cost = total/corpus.size();
+        return report;
+
+    }
+
+}
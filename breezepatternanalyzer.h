@@ -0,0 +1,109 @@
+#ifndef breezepatternanalyzer_h
+#define breezepatternanalyzer_h
+
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QString>
+#include <QStringList>
+#include <QtGlobal>
+
+namespace SierraBreeze
+{
+
+    //* cost analysis of exception patterns
+    /**
+    exception patterns are matched against every new window. Patterns are checked statically for
+    constructs prone to catastrophic backtracking, and timed against a built-in corpus of class names and titles,
+    in cpu time of the calling thread.
+    */
+    class PatternAnalyzer
+    {
+
+        public:
+
+        //* average matching cost above which a pattern is refused, in nanoseconds per window
+        static constexpr qint64 Budget = 20000;
+
+        //* single match cost above which a pattern is refused, in nanoseconds
+        static constexpr qint64 WorstCaseBudget = 10*Budget;
+
+        //* analysis time above which a pattern is refused, in milliseconds
+        static constexpr int AnalysisDeadline = 1000;
+
+        //* risky constructs
+        enum Hazard
+        {
+            NoHazard = 0,
+
+            //* unbounded quantifier applied to a group that contains one, as in (a+)+
+            NestedQuantifier = 1<<0,
+
+            //* unbounded quantifier applied to alternatives that can match the same text, as in (a|ab)*
+            OverlappingAlternation = 1<<1,
+
+            //* consecutive unbounded wildcards, as in .*.*
+            AdjacentWildcards = 1<<2,
+
+            //* back references disable most regular expression engine optimizations
+            BackReference = 1<<3
+        };
+
+        //* analysis result
+        struct Report
+        {
+            //* false if the pattern does not compile
+            bool valid = false;
+
+            //* compilation error
+            QString error;
+
+            //* risky constructs, combination of Hazard values
+            int hazards = NoHazard;
+
+            //* average match cost over the corpus, in nanoseconds
+            qint64 cost = 0;
+
+            //* most expensive match over the corpus, in nanoseconds
+            qint64 worstCost = 0;
+
+            //* true if the decoration refuses the pattern
+            bool isOverBudget( void ) const
+            { return cost > Budget || worstCost > WorstCaseBudget; }
+        };
+
+        //* static analysis only
+        static int hazards( const QString& pattern );
+
+        //* compile, check and time pattern against the corpus matching exception type
+        static Report analyze( const QString& pattern, int exceptionType );
+
+        //* built-in class names or titles, depending on exception type
+        static const QStringList& corpus( int exceptionType );
+
+        //* cpu time of the calling thread, in nanoseconds. Unlike wall time, it does not count preemption
+        /** budgets are meant for this clock, both when analyzing and when matching */
+        static qint64 threadTime( void );
+
+    };
+
+}
+
+#endif
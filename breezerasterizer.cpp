@@ -0,0 +1,93 @@
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breezerasterizer.h"
+#include "breezetracing.h"
+
+#include <cmath>
+
+namespace SierraBreeze
+{
+
+    //__________________________________________________________________
+    void Rasterizer::blendRow( QRgb* pixels, const float* coverage, int count, const float color[4] )
+    {
+        for( int i = 0; i < count; ++i )
+        {
+            const QRgb pixel( pixels[i] );
+            const float weight( coverage[i] );
+            const float inverse( 1.0f - color[0]*weight*( 1.0f/255 ) );
+
+            const uint alpha( color[0]*weight + qAlpha( pixel )*inverse + 0.5f );
+            const uint red( color[1]*weight + qRed( pixel )*inverse + 0.5f );
+            const uint green( color[2]*weight + qGreen( pixel )*inverse + 0.5f );
+            const uint blue( color[3]*weight + qBlue( pixel )*inverse + 0.5f );
+            pixels[i] = ( alpha << 24 ) | ( red << 16 ) | ( green << 8 ) | blue;
+        }
+    }
+
+    //__________________________________________________________________
+    bool Rasterizer::isEnabled( void )
+    {
+        static const bool enabled( qEnvironmentVariableIsEmpty( "SIERRABREEZE_RASTERIZER" ) || qEnvironmentVariableIntValue( "SIERRABREEZE_RASTERIZER" ) != 0 );
+        return enabled;
+    }
+
+    //__________________________________________________________________
+    void Rasterizer::crossfade( QImage& target, const QImage& from, const QImage& to, qreal ratio )
+    {
+        BREEZE_TRACE_SCOPE( "Rasterizer::crossfade" );
+
+        if( target.size() != from.size() || to.size() != from.size() ) return;
+
+        /*
+        8 bit fixed point weights. Red and blue, then alpha and green, are interpolated two at a time
+        in the 0x00ff00ff lanes of a 32 bit word; the loop has no branch and is vectorized by the compiler
+        */
+        const quint32 weight( qBound( 0, qRound( ratio*256 ), 256 ) );
+        const quint32 inverse( 256 - weight );
+        for( int y = 0; y < target.height(); ++y )
+        {
+            const quint32* source( reinterpret_cast<const quint32*>( from.constScanLine( y ) ) );
+            const quint32* destination( reinterpret_cast<const quint32*>( to.constScanLine( y ) ) );
+            quint32* pixels( reinterpret_cast<quint32*>( target.scanLine( y ) ) );
+            for( int x = 0; x < target.width(); ++x )
+            {
+                const quint32 redBlue( ( ( source[x] & 0x00ff00ff )*inverse + ( destination[x] & 0x00ff00ff )*weight ) >> 8 );
+                const quint32 alphaGreen( ( ( source[x] >> 8 ) & 0x00ff00ff )*inverse + ( ( destination[x] >> 8 ) & 0x00ff00ff )*weight );
+                pixels[x] = ( redBlue & 0x00ff00ff ) | ( alphaGreen & 0xff00ff00 );
+            }
+        }
+    }
+
+    //__________________________________________________________________
+    void Rasterizer::fillCircle( QImage& image, const QPointF& center, qreal radius, const QColor& color )
+    {
+        BREEZE_TRACE_SCOPE( "Rasterizer::fillCircle" );
+
+        const float cx( center.x() );
+        const float cy( center.y() );
+        const float r( radius );
+        fill( image, QRectF( center.x() - radius, center.y() - radius, 2*radius, 2*radius ), color,
+            [cx, cy, r]( float x, float y )
+            { return std::sqrt( ( x - cx )*( x - cx ) + ( y - cy )*( y - cy ) ) - r; } );
+    }
+
+}
@@ -0,0 +1,105 @@
+#ifndef breezerasterizer_h
+#define breezerasterizer_h
+
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QColor>
+#include <QImage>
+#include <QPointF>
+#include <QRectF>
+#include <QVarLengthArray>
+
+#include <algorithm>
+
+namespace SierraBreeze
+{
+
+    //* analytic rasterization of the decoration primitives
+    /**
+    primitives are drawn with source over blending straight into ARGB32 premultiplied images,
+    coverage being computed from the exact distance to the shape edge. Rows are processed
+    in branch free loops, that the compiler vectorizes.
+    Coordinates are in image pixels, regardless of the image device pixel ratio.
+    Callers use QPainter when isEnabled() or supports() returns false.
+    */
+    class Rasterizer
+    {
+
+        public:
+
+        //* false when disabled with SIERRABREEZE_RASTERIZER=0, for comparison with QPainter
+        static bool isEnabled( void );
+
+        //* true if image can be rendered into
+        static bool supports( const QImage& image )
+        { return image.format() == QImage::Format_ARGB32_Premultiplied; }
+
+        //* anti-aliased filled circle
+        static void fillCircle( QImage&, const QPointF& center, qreal radius, const QColor& );
+
+        //* fill the pixels inside bounds, coverage being derived from the signed distance to the shape, in pixels
+        template<typename Distance>
+        static void fill( QImage&, const QRectF& bounds, const QColor&, Distance );
+
+        //* per channel linear interpolation between two premultiplied images of the same size, into target
+        static void crossfade( QImage& target, const QImage& from, const QImage& to, qreal ratio );
+
+        private:
+
+        //* source over blending of a premultiplied color, weighted by per pixel coverage
+        static void blendRow( QRgb* pixels, const float* coverage, int count, const float color[4] );
+
+    };
+
+    //__________________________________________________________________
+    template<typename Distance>
+    void Rasterizer::fill( QImage& image, const QRectF& bounds, const QColor& color, Distance distance )
+    {
+
+        const QRect rect( bounds.toAlignedRect().adjusted( -1, -1, 1, 1 ) & image.rect() );
+        if( rect.isEmpty() || !color.alpha() ) return;
+
+        const QRgb premultiplied( qPremultiply( color.rgba() ) );
+        const float source[4] = {
+            float( qAlpha( premultiplied ) ),
+            float( qRed( premultiplied ) ),
+            float( qGreen( premultiplied ) ),
+            float( qBlue( premultiplied ) ) };
+
+        const int count( rect.width() );
+        QVarLengthArray<float, 256> x( count );
+        QVarLengthArray<float, 256> coverage( count );
+        for( int i = 0; i < count; ++i ) x[i] = rect.left() + i + 0.5f;
+
+        for( int row = rect.top(); row <= rect.bottom(); ++row )
+        {
+            const float y( row + 0.5f );
+            for( int i = 0; i < count; ++i )
+            { coverage[i] = std::clamp( 0.5f - distance( x[i], y ), 0.0f, 1.0f ); }
+
+            blendRow( reinterpret_cast<QRgb*>( image.scanLine( row ) ) + rect.left(), coverage.constData(), count, source );
+        }
+
+    }
+
+}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef breezerendercache_h
+#define breezerendercache_h
+
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QSharedPointer>
+
+namespace SierraBreeze
+{
+
+    //* rendered images, cached per device pixel ratio
+    /**
+    each scale has its own bounded cache, so that windows on a 1x output never
+    evict the assets used by windows on a 2x output, and a window moving between
+    outputs finds the assets of the other scale already rendered.
+    Cost is accounted in kilobytes.
+    */
+    template<typename Key> class RenderCache
+    {
+
+        public:
+
+        //* constructor
+        explicit RenderCache( int maxCostPerScale ):
+            m_maxCost( maxCostPerScale )
+        {}
+
+        //* cached image for given scale and key, nullptr if not found
+        const QImage* find( qreal devicePixelRatio, const Key& key ) const
+        {
+            const auto iter = m_caches.constFind( devicePixelRatio );
+            return iter == m_caches.constEnd() ? nullptr : iter.value()->object( key );
+        }
+
+        //* insert image. Its device pixel ratio selects the cache
+        const QImage* insert( const Key& key, const QImage& image )
+        {
+            const qreal devicePixelRatio( image.devicePixelRatio() );
+            auto& cache( m_caches[devicePixelRatio] );
+            if( !cache ) cache.reset( new QCache<Key, QImage>( m_maxCost ) );
+
+            auto copy = new QImage( image );
+            const qsizetype cost = qMax<qsizetype>( 1, image.sizeInBytes()/1024 );
+            return cache->insert( key, copy, cost ) ? copy : nullptr;
+        }
+
+        //* clear all scales
+        void clear( void )
+        { m_caches.clear(); }
+
+        private:
+
+        //* max cost per scale
+        int m_maxCost;
+
+        //* one cache per scale
+        QHash<qreal, QSharedPointer<QCache<Key, QImage>>> m_caches;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,209 @@
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breezeruleanalyzer.h"
+#include "breezeexceptionmatcher.h"
+#include "breezepatternanalyzer.h"
+
+#include <QHash>
+#include <QRegularExpression>
+#include <QSet>
+
+#include <algorithm>
+#include <limits>
+
+namespace SierraBreeze
+{
+
+    namespace
+    {
+
+        //* text of a regular expression made of plain characters only, null otherwise
+        QString plainText( const QString& pattern )
+        {
+            static const QString special( QStringLiteral( ".^$*+?()[]{}|" ) );
+
+            QString out;
+            for( int i = 0; i < pattern.size(); ++i )
+            {
+                const QChar c( pattern[i] );
+                if( c == QLatin1Char( '\\' ) )
+                {
+                    // escaped punctuation is plain, other escapes are classes or assertions
+                    if( i+1 >= pattern.size() || pattern[i+1].isLetterOrNumber() ) return QString();
+                    out.append( pattern[++i] );
+                } else if( special.contains( c ) ) return QString();
+                else out.append( c );
+            }
+
+            return out;
+        }
+
+        //* true if pattern matches any window
+        bool isUniversal( const QString& pattern, int kind )
+        {
+            switch( kind )
+            {
+                case InternalSettings::PatternLiteral:
+                return false;
+
+                case InternalSettings::PatternGlob:
+                return !pattern.isEmpty() && std::all_of( pattern.begin(), pattern.end(), []( QChar c ) { return c == QLatin1Char( '*' ); } );
+
+                default:
+                case InternalSettings::PatternRegExp:
+                {
+                    /*
+                    without anchors or assertions, an expression that matches the empty string
+                    matches at the start of any string
+                    */
+                    static const QRegularExpression assertions( QStringLiteral( "[\\^$]|\\\\[bBAzZG]|\\(\\?" ) );
+                    if( pattern.contains( assertions ) ) return false;
+                    const QRegularExpression expression( pattern );
+                    return expression.isValid() && expression.match( QString() ).hasMatch();
+                }
+            }
+        }
+
+        //* text that every window matched by pattern contains, empty if unknown
+        QString requiredText( const QString& pattern, int kind )
+        {
+            switch( kind )
+            {
+                case InternalSettings::PatternLiteral:
+                return pattern;
+
+                case InternalSettings::PatternGlob:
+                {
+                    // longest run without wildcards
+                    if( pattern.contains( QLatin1Char( '[' ) ) || pattern.contains( QLatin1Char( '\\' ) ) ) return QString();
+                    QString best;
+                    const auto runs( pattern.split( QRegularExpression( QStringLiteral( "[*?]" ) ) ) );
+                    for( const QString& run : runs ) { if( run.size() > best.size() ) best = run; }
+                    return best;
+                }
+
+                default:
+                case InternalSettings::PatternRegExp:
+                return ExceptionMatcher::requiredLiteral( pattern );
+            }
+        }
+
+        //* check a shadowing proof against the corpus and the exceptions own text
+        bool confirmShadowing( const InternalSettingsPtr& earlier, const InternalSettingsPtr& later )
+        {
+
+            ExceptionMatcher matcher;
+            matcher.build( { earlier, later } );
+
+            const int type( later->exceptionType() );
+            QStringList samples( PatternAnalyzer::corpus( type ) );
+            for( const auto& exception : { earlier, later } )
+            {
+                const QString text( requiredText( exception->exceptionPattern(), exception->exceptionPatternKind() ) );
+                if( text.isEmpty() ) continue;
+                samples.append( type == InternalSettings::ExceptionWindowTitle ? text : text + QLatin1Char( ' ' ) + text );
+            }
+
+            for( const QString& sample : std::as_const( samples ) )
+            {
+                const QString& className( type == InternalSettings::ExceptionWindowTitle ? QString() : sample );
+                const QString& title( type == InternalSettings::ExceptionWindowTitle ? sample : QString() );
+                if( matcher.matches( 1, className, title ) && !matcher.matches( 0, className, title ) ) return false;
+            }
+
+            return true;
+
+        }
+
+    }
+
+    //__________________________________________________________________
+    QList<RuleAnalyzer::Finding> RuleAnalyzer::analyze( const InternalSettingsList& exceptions )
+    {
+
+        QList<Finding> out;
+
+        // first exception for a given type, kind and pattern
+        QHash<QString, int> keys;
+
+        // per type: first exception matching any window, first plain-text expression for a given text, and text lengths
+        int universal[2] = { std::numeric_limits<int>::max(), std::numeric_limits<int>::max() };
+        QHash<QString, int> plainTexts[2];
+        QSet<int> plainLengths[2];
+
+        for( int index = 0; index < exceptions.size(); ++index )
+        {
+
+            const auto& exception( exceptions[index] );
+            const QString pattern( exception->exceptionPattern() );
+            const int kind( exception->exceptionPatternKind() );
+            const int type( exception->exceptionType() == InternalSettings::ExceptionWindowTitle ? 1 : 0 );
+
+            if( !exception->enabled() || pattern.isEmpty() || !QRegularExpression( ExceptionMatcher::regularExpression( pattern, kind ) ).isValid() )
+            {
+                out.append( { index, Inactive, -1 } );
+                continue;
+            }
+
+            const QString key( QStringLiteral( "%1|%2|%3" ).arg( type ).arg( kind ).arg( pattern ) );
+            const int duplicate( keys.value( key, -1 ) );
+            if( duplicate >= 0 )
+            {
+                out.append( { index, Duplicate, duplicate } );
+                continue;
+            }
+
+            keys.insert( key, index );
+
+            // earliest exception proven to match every window this one does
+            int cause( universal[type] );
+            const QString text( requiredText( pattern, kind ) );
+            for( int length : std::as_const( plainLengths[type] ) )
+            {
+                for( int position = 0; position + length <= text.size(); ++position )
+                { cause = qMin( cause, plainTexts[type].value( text.mid( position, length ), cause ) ); }
+            }
+
+            if( cause < index && confirmShadowing( exceptions[cause], exception ) )
+            {
+                out.append( { index, Shadowed, cause, cause == universal[type] } );
+                continue;
+            }
+
+            // this exception may shadow later ones
+            if( isUniversal( pattern, kind ) ) universal[type] = qMin( universal[type], index );
+            if( kind == InternalSettings::PatternRegExp )
+            {
+                const QString plain( plainText( pattern ) );
+                if( !plain.isEmpty() && !plainTexts[type].contains( plain ) )
+                {
+                    plainTexts[type].insert( plain, index );
+                    plainLengths[type].insert( plain.size() );
+                }
+            }
+
+        }
+
+        return out;
+
+    }
+
+}
@@ -0,0 +1,79 @@
+#ifndef breezeruleanalyzer_h
+#define breezeruleanalyzer_h
+
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breeze.h"
+
+#include <QList>
+
+namespace SierraBreeze
+{
+
+    //* finds exceptions that can never apply
+    /**
+    exceptions are first-match, so a later exception is unreachable when an earlier one of the same type
+    matches every window it would. Shadowing is certain when the earlier pattern matches any window.
+    It is otherwise inferred from an earlier plain-text regular expression contained in every window the later
+    exception matches, as far as the built-in corpus and the literal text of both exceptions tell.
+    */
+    class RuleAnalyzer
+    {
+
+        public:
+
+        //* issues
+        enum Issue
+        {
+            //* disabled, empty or invalid pattern
+            Inactive,
+
+            //* same type, kind and pattern as an earlier exception
+            Duplicate,
+
+            //* every window it matches is matched by an earlier exception
+            Shadowed
+        };
+
+        //* issue found for an exception
+        struct Finding
+        {
+            //* exception index
+            int index = -1;
+
+            //* issue
+            Issue issue = Inactive;
+
+            //* index of the earlier exception responsible for a duplicate or shadowed exception, -1 otherwise
+            int cause = -1;
+
+            //* true when the cause matches any window. Only then, or for duplicates, is the finding certain
+            bool universalCause = false;
+        };
+
+        //* issues of given exceptions, in priority order
+        static QList<Finding> analyze( const InternalSettingsList& );
+
+    };
+
+}
+
+#endif
@@ -20,23 +20,82 @@
 
 #include "breezesettingsprovider.h"
 
+#include "breezeanimationgovernor.h"
 #include "breezeexceptionlist.h"
+#include "breezeexceptionmatcher.h"
+#include "breezepatternanalyzer.h"
+#include "breezeruleanalyzer.h"
+#include "breezestatistics.h"
+#include "breezetracing.h"
 
+#include <KConfigGroup>
+#include <KDirWatch>
 #include <KWindowInfo>
 
+#include <QDBusConnection>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QSet>
+#include <QStandardPaths>
 #include <QTextStream>
+#include <QTimer>
+#include <QtConcurrentRun>
 
-#include <qregularexpression.h>
 
 namespace SierraBreeze
 {
 
+    namespace
+    {
+
+        //* patterns to analyze, by key
+        using Patterns = QHash<QString, std::pair<int, QString>>;
+
+        //* analysis reports, by key
+        using Reports = QHash<QString, PatternAnalyzer::Report>;
+
+        //* key of a pattern, as its cost depends on the window property it is matched against
+        QString patternKey( int exceptionType, const QString& pattern )
+        { return QStringLiteral( "%1|%2" ).arg( exceptionType ).arg( pattern ); }
+
+        //* analyze patterns. Runs in a worker thread
+        Reports analyzeAll( const Patterns& patterns )
+        {
+            Reports reports;
+            for( auto iter = patterns.cbegin(); iter != patterns.cend(); ++iter )
+            { reports.insert( iter.key(), PatternAnalyzer::analyze( iter.value().second, iter.value().first ) ); }
+
+            return reports;
+        }
+
+    }
+
     SettingsProvider *SettingsProvider::s_self = nullptr;
 
     //__________________________________________________________________
     SettingsProvider::SettingsProvider():
-        m_config( KSharedConfig::openConfig( QStringLiteral("breezerc") ) )
-    { reconfigure(); }
+        m_config( KSharedConfig::openConfig( QStringLiteral("breezerc") ) ),
+        m_watcher( new KDirWatch( this ) ),
+        m_reparseTimer( new QTimer( this ) )
+    {
+        reconfigure();
+
+        // targeted reload, sent by the configuration module instead of a full kwin reconfiguration
+        QDBusConnection::sessionBus().connect( QString(),
+            QStringLiteral( "/SierraBreeze" ), QStringLiteral( "org.kde.SierraBreeze" ), QStringLiteral( "reloadConfig" ),
+            this, SLOT(reloadConfig(QStringList,bool)) );
+
+        // changes made by other means, for instance kwriteconfig or a text editor
+        m_reparseTimer->setSingleShot( true );
+        m_reparseTimer->setInterval( 100 );
+        connect( m_reparseTimer, &QTimer::timeout, this, &SettingsProvider::reparseConfiguration );
+
+        m_watcher->addFile( QStandardPaths::writableLocation( QStandardPaths::GenericConfigLocation ) + QStringLiteral( "/breezerc" ) );
+        connect( m_watcher, &KDirWatch::dirty, m_reparseTimer, qOverload<>( &QTimer::start ) );
+        connect( m_watcher, &KDirWatch::created, m_reparseTimer, qOverload<>( &QTimer::start ) );
+        connect( m_watcher, &KDirWatch::deleted, m_reparseTimer, qOverload<>( &QTimer::start ) );
+    }
 
     //__________________________________________________________________
     SettingsProvider::~SettingsProvider()
@@ -61,71 +120,461 @@ namespace SierraBreeze
             m_defaultSettings->setCurrentGroup( QStringLiteral("Windeco") );
         }
 
+        m_config->reparseConfiguration();
+        m_snapshot = snapshot();
+
         m_defaultSettings->load();
 
+        // animation limits are shared by all windows
+        AnimationGovernor::self().setPolicy(
+            m_defaultSettings->maxConcurrentAnimations(),
+            m_defaultSettings->reducedMotionUnderLoad(),
+            m_defaultSettings->animationFrameBudget() );
+
         ExceptionList exceptions;
         exceptions.readConfig( m_config );
         m_exceptions = exceptions.get();
+        updateMatcher();
 
     }
 
     //__________________________________________________________________
-    InternalSettingsPtr SettingsProvider::internalSettings( Decoration *decoration ) const
+    void SettingsProvider::reloadConfig( const QStringList& keys, bool exceptionsChanged )
     {
+        BREEZE_TRACE_SCOPE( "SettingsProvider::reloadConfig" );
 
-        QString windowTitle;
-        QString className;
+        /*
+        the configuration module tells what it saved, so there is nothing to compare.
+        The snapshot is still taken, so that the file watcher finds no change when it notifies
+        */
+        m_reparseTimer->stop();
+        m_config->reparseConfiguration();
+        m_snapshot = snapshot();
+        applyChanges( keys, exceptionsChanged );
+    }
 
-        // get the client
-        auto client = decoration->client();
+    //__________________________________________________________________
+    SettingsProvider::Snapshot SettingsProvider::snapshot( void ) const
+    {
+        /*
+        the file is shared with the widget style. Only the entries the decoration reads are compared,
+        which includes the shadow entries of the Common group
+        */
+        Snapshot snapshot;
+        const auto items( m_defaultSettings->items() );
+        for( const KConfigSkeletonItem* item : items )
+        {
+            const KConfigGroup settingsGroup( m_config, item->group() );
+            if( settingsGroup.hasKey( item->key() ) ) snapshot[item->group()].insert( item->key(), settingsGroup.readEntry( item->key(), QString() ) );
+        }
+
+        QString group;
+        for( int index = 0; m_config->hasGroup( group = ExceptionList::exceptionGroupName( index ) ); ++index )
+        { snapshot.insert( group, m_config->group( group ).entryMap() ); }
+
+        return snapshot;
+    }
+
+    //__________________________________________________________________
+    void SettingsProvider::reparseConfiguration( void )
+    {
+        BREEZE_TRACE_SCOPE( "SettingsProvider::reparseConfiguration" );
+
+        m_config->reparseConfiguration();
+        const Snapshot current( snapshot() );
+
+        // compare groups, and the entries of the settings groups
+        QStringList keys;
+        bool exceptionsChanged( false );
+
+        QStringList groups( current.keys() + m_snapshot.keys() );
+        groups.removeDuplicates();
+        for( const QString& group : std::as_const( groups ) )
+        {
+
+            const auto before( m_snapshot.value( group ) );
+            const auto after( current.value( group ) );
+            if( before == after ) continue;
+
+            if( group.startsWith( QLatin1String( "Windeco Exception" ) ) )
+            {
+                exceptionsChanged = true;
+                continue;
+            }
+
+            QStringList entries( before.keys() + after.keys() );
+            entries.removeDuplicates();
+            for( const QString& key : std::as_const( entries ) )
+            { if( before.value( key ) != after.value( key ) && !keys.contains( key ) ) keys.append( key ); }
+
+        }
+
+        m_snapshot = current;
+        applyChanges( keys, exceptionsChanged );
+    }
 
-        foreach( auto internalSettings, m_exceptions )
+    //__________________________________________________________________
+    void SettingsProvider::applyChanges( const QStringList& keys, bool exceptionsChanged )
+    {
+        if( keys.isEmpty() && !exceptionsChanged ) return;
+
+        // only parse again what changed
+        if( !keys.isEmpty() )
         {
+            m_defaultSettings->load();
+            AnimationGovernor::self().setPolicy(
+                m_defaultSettings->maxConcurrentAnimations(),
+                m_defaultSettings->reducedMotionUnderLoad(),
+                m_defaultSettings->animationFrameBudget() );
+        }
+
+        // exceptions start from the default settings, so they depend on both
+        const InternalSettingsList previous( m_exceptions );
+        ExceptionList exceptions;
+        exceptions.readConfig( m_config );
+        m_exceptions = exceptions.get();
+        updateMatcher();
 
-            // discard disabled exceptions
-            if( !internalSettings->enabled() ) continue;
+        // with default settings unchanged, only windows whose exception changes need an update
+        if( keys.isEmpty() )
+        {
+            reapplyExceptions( previous );
+            return;
+        }
 
-            // discard exceptions with empty exception pattern
-            if( internalSettings->exceptionPattern().isEmpty() ) continue;
+        Q_EMIT settingsChanged( keys );
+    }
 
-            /*
-            decide which value is to be compared
-            to the regular expression, based on exception type
-            */
-            QString value;
-            switch( internalSettings->exceptionType() )
+    //__________________________________________________________________
+    void SettingsProvider::updateMatcher( void )
+    {
+
+        BREEZE_TRACE_SCOPE( "SettingsProvider::updateMatcher" );
+
+        /*
+        timing a pattern prone to catastrophic backtracking may take arbitrarily long, so it is not done here.
+        Such patterns are refused until analyzed in the background
+        */
+        QSet<int> refused;
+        bool unknown( false );
+        for( int index = 0; index < m_exceptions.size(); ++index )
+        {
+
+            const auto& exception( m_exceptions[index] );
+            const QString pattern( exception->exceptionPattern() );
+            if( !exception->enabled() || pattern.isEmpty() ) continue;
+            if( exception->exceptionPatternKind() != InternalSettings::PatternRegExp ) continue;
+
+            // only patterns with risky constructs are worth timing
+            if( !PatternAnalyzer::hazards( pattern ) ) continue;
+
+            const QString key( patternKey( exception->exceptionType(), pattern ) );
+            const auto iter( m_overBudget.constFind( key ) );
+            if( iter == m_overBudget.cend() ) unknown = true;
+            if( iter == m_overBudget.cend() || iter.value() ) refused.insert( index );
+
+        }
+
+        /*
+        duplicates and exceptions hidden by one that matches any window are left out, unless what hides them is itself ignored.
+        Exceptions shadowed by text containment are only reported in the configuration module
+        */
+        QSet<int> unreachable;
+        const auto findings( RuleAnalyzer::analyze( m_exceptions ) );
+        for( const auto& finding : findings )
+        {
+            if( finding.cause < 0 || refused.contains( finding.cause ) ) continue;
+            if( finding.issue == RuleAnalyzer::Shadowed && !finding.universalCause ) continue;
+            unreachable.insert( finding.index );
+        }
+
+        m_matcher.build( m_exceptions, refused | unreachable );
+
+        if( unknown ) analyzePatterns();
+
+    }
+
+    //__________________________________________________________________
+    void SettingsProvider::analyzePatterns( void )
+    {
+
+        Patterns patterns;
+        for( const auto& exception : std::as_const( m_exceptions ) )
+        {
+            const QString pattern( exception->exceptionPattern() );
+            if( !exception->enabled() || pattern.isEmpty() ) continue;
+            if( exception->exceptionPatternKind() != InternalSettings::PatternRegExp ) continue;
+            if( !PatternAnalyzer::hazards( pattern ) ) continue;
+
+            const QString key( patternKey( exception->exceptionType(), pattern ) );
+            if( m_overBudget.contains( key ) || m_analyzing.contains( key ) ) continue;
+
+            patterns.insert( key, { exception->exceptionType(), pattern } );
+            m_analyzing.insert( key );
+        }
+
+        if( patterns.isEmpty() ) return;
+
+        /*
+        a match cannot be interrupted, so patterns still being analyzed at the deadline are refused,
+        and their reports dropped whenever they come
+        */
+        auto watcher( new QFutureWatcher<Reports>( this ) );
+        auto deadline( new QTimer( watcher ) );
+        deadline->setSingleShot( true );
+        deadline->setInterval( PatternAnalyzer::AnalysisDeadline*patterns.size() );
+
+        connect( deadline, &QTimer::timeout, this, [this, patterns]()
+        {
+            for( auto iter = patterns.cbegin(); iter != patterns.cend(); ++iter )
             {
-                case InternalSettings::ExceptionWindowTitle:
+                qWarning().nospace() << "SierraBreeze: exception pattern " << iter.value().second
+                    << " takes too long to analyze, it is ignored";
+                m_overBudget.insert( iter.key(), true );
+                m_analyzing.remove( iter.key() );
+            }
+        } );
+
+        connect( watcher, &QFutureWatcherBase::finished, this, [this, watcher, deadline]()
+        {
+            if( deadline->isActive() )
+            {
+                deadline->stop();
+                applyVerdicts( watcher->result() );
+            }
+
+            watcher->deleteLater();
+        } );
+
+        watcher->setFuture( QtConcurrent::run( &analyzeAll, patterns ) );
+        deadline->start();
+
+    }
+
+    //__________________________________________________________________
+    void SettingsProvider::applyVerdicts( const QHash<QString, PatternAnalyzer::Report>& reports )
+    {
+
+        BREEZE_TRACE_SCOPE( "SettingsProvider::applyVerdicts" );
+
+        bool accepted( false );
+        for( auto iter = reports.cbegin(); iter != reports.cend(); ++iter )
+        {
+            const auto& report( iter.value() );
+            if( report.isOverBudget() )
+            {
+                qWarning().nospace() << "SierraBreeze: exception pattern " << iter.key().section( QLatin1Char( '|' ), 1 )
+                    << " costs up to " << report.worstCost/1000 << "us per window, it is ignored";
+            } else accepted = true;
+
+            m_overBudget.insert( iter.key(), report.isOverBudget() );
+            m_analyzing.remove( iter.key() );
+        }
+
+        // refused patterns were left out already
+        if( !accepted ) return;
+        updateMatcher();
+
+        // exceptions that are no longer refused, in priority order
+        QList<int> added;
+        QStringList keys;
+        for( int index = 0; index < m_exceptions.size(); ++index )
+        {
+            const auto& exception( m_exceptions[index] );
+            keys.append( ruleKey( *exception ) );
+
+            const auto iter( reports.constFind( patternKey( exception->exceptionType(), exception->exceptionPattern() ) ) );
+            if( iter != reports.cend() && !iter.value().isOverBudget() && exception->enabled() &&
+                exception->exceptionPatternKind() == InternalSettings::PatternRegExp )
+            { added.append( index ); }
+        }
+
+        // windows only move to one of these exceptions if it has higher priority than the one they matched
+        QList<Decoration*> affected;
+        for( auto iter = m_matches.cbegin(); iter != m_matches.cend(); ++iter )
+        {
+
+            const int priority( iter.value().isEmpty() ? keys.size() : keys.indexOf( iter.value() ) );
+            if( added.isEmpty() || added.front() >= priority ) continue;
+
+            QString className;
+            QString title;
+            windowProperties( iter.key(), className, title );
+            for( int index : std::as_const( added ) )
+            {
+                if( index >= priority ) break;
+                if( m_matcher.matches( index, className, title ) )
                 {
-                    value = windowTitle.isEmpty() ? (windowTitle = client->caption()):windowTitle;
+                    affected.append( iter.key() );
                     break;
                 }
+            }
+
+        }
+
+        for( Decoration* decoration : std::as_const( affected ) )
+        { decoration->updateSettings( QStringList() ); }
+
+    }
+
+    //__________________________________________________________________
+    QString SettingsProvider::ruleKey( const InternalSettings& exception )
+    {
+        return QStringLiteral( "%1|%2|%3|%4|%5|%6|%7" )
+            .arg( exception.enabled() )
+            .arg( exception.exceptionType() )
+            .arg( exception.exceptionPatternKind() )
+            .arg( exception.mask() )
+            .arg( exception.borderSize() )
+            .arg( exception.hideTitleBar() )
+            .arg( exception.exceptionPattern() );
+    }
+
+    //__________________________________________________________________
+    void SettingsProvider::reapplyExceptions( const InternalSettingsList& previous )
+    {
+
+        BREEZE_TRACE_SCOPE( "SettingsProvider::reapplyExceptions" );
+
+        QStringList before;
+        for( const auto& exception : previous ) before.append( ruleKey( *exception ) );
+
+        QStringList after;
+        for( const auto& exception : std::as_const( m_exceptions ) ) after.append( ruleKey( *exception ) );
+
+        const QSet<QString> beforeKeys( before.begin(), before.end() );
+        const QSet<QString> afterKeys( after.begin(), after.end() );
 
-                default:
-                case InternalSettings::ExceptionWindowClassName:
+        // rules that were removed or edited, and position of rules that were added or edited
+        const QSet<QString> removed( QSet<QString>( beforeKeys ).subtract( afterKeys ) );
+
+        QList<int> added;
+        for( int index = 0; index < after.size(); ++index )
+        { if( !beforeKeys.contains( after[index] ) ) added.append( index ); }
+
+        // rules present on both sides must keep their relative priority, otherwise any window may move
+        QStringList keptBefore( before );
+        keptBefore.removeIf( [&afterKeys]( const QString& key ) { return !afterKeys.contains( key ); } );
+        QStringList keptAfter( after );
+        keptAfter.removeIf( [&beforeKeys]( const QString& key ) { return !beforeKeys.contains( key ); } );
+        const bool reordered( keptBefore != keptAfter );
+
+        // group windows by the rule they matched
+        QHash<QString, QList<Decoration*>> windows;
+        for( auto iter = m_matches.cbegin(); iter != m_matches.cend(); ++iter )
+        { windows[iter.value()].append( iter.key() ); }
+
+        QList<Decoration*> affected;
+        for( auto iter = windows.cbegin(); iter != windows.cend(); ++iter )
+        {
+
+            const QString& match( iter.key() );
+            if( reordered || removed.contains( match ) )
+            {
+                affected.append( iter.value() );
+                continue;
+            }
+
+            // otherwise, windows only move to an added rule of higher priority that matches them
+            const int priority( match.isEmpty() ? after.size() : after.indexOf( match ) );
+            if( added.isEmpty() || added.front() >= priority ) continue;
+            for( Decoration* decoration : iter.value() )
+            {
+                QString className;
+                QString title;
+                windowProperties( decoration, className, title );
+                for( int index : std::as_const( added ) )
                 {
-                    if( className.isEmpty() )
+                    if( index >= priority ) break;
+                    if( m_matcher.matches( index, className, title ) )
                     {
-                        // retrieve class name
-                        KWindowInfo info( client->windowId(), {}, NET::WM2WindowClass );
-                        QString window_className( QString::fromUtf8(info.windowClassName()) );
-                        QString window_class( QString::fromUtf8(info.windowClassClass()) );
-                        className = window_className + QStringLiteral(" ") + window_class;
+                        affected.append( decoration );
+                        break;
                     }
-
-                    value = className;
-                    break;
                 }
-
             }
 
-            // check matching
-            if ( QRegularExpression( internalSettings->exceptionPattern() ).match( value ).hasMatch() )
-            { return internalSettings; }
+        }
+
+        for( Decoration* decoration : std::as_const( affected ) )
+        { decoration->updateSettings( QStringList() ); }
+
+        scheduleRefused();
+
+    }
+
+    //__________________________________________________________________
+    void SettingsProvider::scheduleRefused( void ) const
+    {
+
+        const QList<int> refused( m_matcher.takeRefused() );
+        if( refused.isEmpty() ) return;
+
+        QSet<QString> keys;
+        for( int index : refused ) keys.insert( ruleKey( *m_exceptions[index] ) );
+
+        // not from within the resolution that refused them, which may be one of these windows
+        QTimer::singleShot( 0, this, [this, keys]()
+        {
+            QList<Decoration*> affected;
+            for( auto iter = m_matches.cbegin(); iter != m_matches.cend(); ++iter )
+            { if( keys.contains( iter.value() ) ) affected.append( iter.key() ); }
+
+            for( Decoration* decoration : std::as_const( affected ) )
+            { decoration->updateSettings( QStringList() ); }
+        } );
+
+    }
+
+    //__________________________________________________________________
+    void SettingsProvider::windowProperties( Decoration* decoration, QString& className, QString& title ) const
+    {
+
+        auto client = decoration->client();
+        if( m_matcher.uses( InternalSettings::ExceptionWindowTitle ) )
+        { title = client->caption(); }
+
+        if( m_matcher.uses( InternalSettings::ExceptionWindowClassName ) )
+        {
+            // retrieve class name
+            KWindowInfo info( client->windowId(), {}, NET::WM2WindowClass );
+            QString window_className( QString::fromUtf8(info.windowClassName()) );
+            QString window_class( QString::fromUtf8(info.windowClassClass()) );
+            className = window_className + QStringLiteral(" ") + window_class;
+        }
+
+    }
 
+    //__________________________________________________________________
+    InternalSettingsPtr SettingsProvider::internalSettings( Decoration *decoration ) const
+    {
+
+        BREEZE_TRACE_SCOPE( "SettingsProvider::internalSettings" );
+
+        QElapsedTimer timer;
+        timer.start();
+
+        // forget windows once closed
+        if( !m_matches.contains( decoration ) )
+        { connect( decoration, &QObject::destroyed, this, [this, decoration]() { m_matches.remove( decoration ); } ); }
+
+        QString className;
+        QString title;
+        windowProperties( decoration, className, title );
+
+        const int index( m_matcher.match( className, title ) );
+        Statistics::recordExceptionMatch( timer.nsecsElapsed() );
+        scheduleRefused();
+
+        if( index < 0 )
+        {
+            m_matches.insert( decoration, QString() );
+            return m_defaultSettings;
         }
 
-        return m_defaultSettings;
+        const auto& internalSettings( m_exceptions[index] );
+        m_matches.insert( decoration, ruleKey( *internalSettings ) );
+        return internalSettings;
 
     }
 
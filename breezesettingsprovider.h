@@ -21,12 +21,20 @@
  */
 
 #include "breezedecoration.h"
+#include "breezeexceptionmatcher.h"
+#include "breezepatternanalyzer.h"
 #include "breezesettings.h"
 #include "breeze.h"
 
 #include <KSharedConfig>
 
+#include <QHash>
+#include <QMap>
 #include <QObject>
+#include <QSet>
+
+class KDirWatch;
+class QTimer;
 
 namespace SierraBreeze
 {
@@ -47,25 +55,93 @@ namespace SierraBreeze
         //* internal settings for given decoration
         InternalSettingsPtr internalSettings(Decoration *) const;
 
+        Q_SIGNALS:
+
+        //* emitted when settings were reloaded on request of the configuration module. Keys are the changed entries
+        /** when only exceptions changed, affected decorations are notified directly instead */
+        void settingsChanged( const QStringList& keys );
+
         public Q_SLOTS:
 
         //* reconfigure
         void reconfigure( void );
 
+        //* reload after the configuration module saved given keys and, possibly, exceptions
+        void reloadConfig( const QStringList& keys, bool exceptionsChanged );
+
+        private Q_SLOTS:
+
+        //* reparse the configuration file, reload what changed and notify decorations
+        void reparseConfiguration( void );
+
         private:
 
         //* contructor
         SettingsProvider( void );
 
+        //* decoration settings entries, and entries of each exception group
+        using Snapshot = QHash<QString, QMap<QString, QString>>;
+
+        //* current entries
+        Snapshot snapshot( void ) const;
+
+        //* reload changed settings entries and, possibly, exceptions from the parsed file, and notify decorations
+        void applyChanges( const QStringList& keys, bool exceptionsChanged );
+
+        //* rebuild exception matcher, leaving out unreachable exceptions and patterns too expensive to match against every window
+        /** hazardous patterns are refused until analyzed */
+        void updateMatcher( void );
+
+        //* time, in the background, the hazardous patterns that have no verdict yet
+        void analyzePatterns( void );
+
+        //* store verdicts of analyzed patterns, and move windows to the exceptions that are no longer refused
+        void applyVerdicts( const QHash<QString, PatternAnalyzer::Report>& );
+
+        //* identity of an exception, from everything it applies and matches on
+        static QString ruleKey( const InternalSettings& );
+
+        //* class name and title of decoration's window, as far as exceptions need them
+        void windowProperties( Decoration*, QString& className, QString& title ) const;
+
+        //* update the windows whose matched exception changes between previous and current exceptions
+        void reapplyExceptions( const InternalSettingsList& previous );
+
+        //* update, later on, the windows that matched exceptions the matcher has just refused
+        void scheduleRefused( void ) const;
+
         //* default configuration
         InternalSettingsPtr m_defaultSettings;
 
         //* exceptions
         InternalSettingsList m_exceptions;
 
+        //* key of the exception each decoration matched at last resolution, empty for default settings
+        /** reverse lookup, from exception to windows, is done when exceptions change */
+        mutable QHash<Decoration*, QString> m_matches;
+
+        //* exception lookup
+        ExceptionMatcher m_matcher;
+
+        //* whether hazardous patterns are over budget, by exception type and pattern
+        /** kept across reloads, so that patterns are analyzed once */
+        QHash<QString, bool> m_overBudget;
+
+        //* patterns being analyzed, by exception type and pattern
+        QSet<QString> m_analyzing;
+
         //* config object
         KSharedConfigPtr m_config;
 
+        //* entries at last reload, to find out what changed
+        Snapshot m_snapshot;
+
+        //* configuration file watcher
+        KDirWatch* m_watcher = nullptr;
+
+        //* coalesces the several notifications of one save
+        QTimer* m_reparseTimer = nullptr;
+
         //* singleton
         static SettingsProvider *s_self;
 
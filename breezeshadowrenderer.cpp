@@ -0,0 +1,105 @@
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breezeshadowrenderer.h"
+#include "breeze.h"
+#include "breezetracing.h"
+
+#include <QPainter>
+#include <QRadialGradient>
+
+#include <cmath>
+
+namespace SierraBreeze
+{
+
+    namespace
+    {
+        //* vertical offset of the shadow
+        int shadowOffset( int size )
+        { return qMax( 6*size/16, Metrics::Shadow_Overlap*2 ); }
+    }
+
+    //__________________________________________________________________
+    QImage ShadowRenderer::image( int shadowSize, int shadowStrength, const QColor& shadowColor )
+    {
+        BREEZE_TRACE_SCOPE( "ShadowRenderer::image" );
+
+        const int offset = shadowOffset( shadowSize );
+
+        // create image
+        QImage image(2*shadowSize, 2*shadowSize, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+
+        // create gradient
+        // gaussian delta function
+        auto alpha = [](qreal x) { return std::exp( -x*x/0.15 ); };
+
+        // color calculation delta function
+        auto gradientStopColor = [](QColor color, int alpha)
+        {
+            color.setAlpha(alpha);
+            return color;
+        };
+
+        QRadialGradient radialGradient( shadowSize, shadowSize, shadowSize );
+        for( int i = 0; i < 10; ++i )
+        {
+            const qreal x( qreal( i )/9 );
+            radialGradient.setColorAt(x,  gradientStopColor( shadowColor, alpha(x)*shadowStrength ) );
+        }
+
+        radialGradient.setColorAt(1, gradientStopColor( shadowColor, 0 ) );
+
+        // fill
+        QPainter painter(&image);
+        painter.setRenderHint( QPainter::Antialiasing, true );
+        painter.fillRect( image.rect(), radialGradient);
+
+        // contrast pixel
+        QRectF innerRect = QRectF(
+            shadowSize - Metrics::Shadow_Overlap, shadowSize - offset - Metrics::Shadow_Overlap,
+            2*Metrics::Shadow_Overlap, offset + 2*Metrics::Shadow_Overlap );
+
+        painter.setPen( gradientStopColor( shadowColor, shadowStrength*0.5 ) );
+        painter.setBrush( Qt::NoBrush );
+        painter.drawRoundedRect( innerRect, -0.5 + Metrics::Frame_FrameRadius, -0.5 + Metrics::Frame_FrameRadius );
+
+        // mask out inner rect
+        painter.setPen( Qt::NoPen );
+        painter.setBrush( Qt::black );
+        painter.setCompositionMode(QPainter::CompositionMode_DestinationOut );
+        painter.drawRoundedRect( innerRect, 0.5 + Metrics::Frame_FrameRadius, 0.5 + Metrics::Frame_FrameRadius );
+
+        painter.end();
+        return image;
+    }
+
+    //__________________________________________________________________
+    QMargins ShadowRenderer::padding( int shadowSize )
+    {
+        return QMargins(
+            shadowSize - Metrics::Shadow_Overlap,
+            shadowSize - shadowOffset( shadowSize ) - Metrics::Shadow_Overlap,
+            shadowSize - Metrics::Shadow_Overlap,
+            shadowSize - Metrics::Shadow_Overlap );
+    }
+
+}
@@ -0,0 +1,52 @@
+#ifndef breezeshadowrenderer_h
+#define breezeshadowrenderer_h
+
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QColor>
+#include <QImage>
+#include <QMargins>
+#include <QRect>
+
+namespace SierraBreeze
+{
+
+    //* window shadow, shared by the decoration and the configuration preview
+    class ShadowRenderer
+    {
+
+        public:
+
+        //* shadow image. Its center pixel is stretched along the window edges
+        static QImage image( int size, int strength, const QColor& );
+
+        //* extent of the shadow outside of the window
+        static QMargins padding( int size );
+
+        //* part of the image covered by the window
+        static QRect innerShadowRect( int size )
+        { return QRect( size, size, 1, 1 ); }
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,216 @@
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breezestatistics.h"
+
+#include "breezedecoration.h"
+
+#include <QDBusConnection>
+
+namespace SierraBreeze
+{
+
+    namespace
+    {
+        //* object path
+        const QString s_objectPath = QStringLiteral( "/SierraBreeze/Stats" );
+
+        //* cache names, as exported in cacheHitRatios
+        const char* const s_cacheNames[ Statistics::CacheCount ] =
+        {
+            "shadow",
+            "buttonSprite"
+        };
+    }
+
+    Statistics *Statistics::s_self = nullptr;
+
+    //__________________________________________________________________
+    Statistics::Statistics()
+    {
+        m_rateTimer.start();
+        QDBusConnection::sessionBus().registerObject( s_objectPath, this,
+            QDBusConnection::ExportAllProperties|QDBusConnection::ExportScriptableSlots );
+    }
+
+    //__________________________________________________________________
+    Statistics::~Statistics()
+    { QDBusConnection::sessionBus().unregisterObject( s_objectPath ); }
+
+    //__________________________________________________________________
+    void Statistics::registerDecoration( const Decoration* decoration )
+    {
+        if( !s_self ) s_self = new Statistics();
+        s_self->m_windows.insert( decoration, WindowStatistics() );
+    }
+
+    //__________________________________________________________________
+    void Statistics::unregisterDecoration( const Decoration* decoration )
+    {
+        if( !s_self ) return;
+        s_self->m_windows.remove( decoration );
+
+        // last decoration destroyed, remove object from the bus
+        if( s_self->m_windows.isEmpty() )
+        {
+            delete s_self;
+            s_self = nullptr;
+        }
+    }
+
+    //__________________________________________________________________
+    void Statistics::recordPaint( const Decoration* decoration, qint64 nanoseconds )
+    {
+        if( !s_self ) return;
+
+        ++s_self->m_paints;
+        ++s_self->m_ratePaints;
+        s_self->m_paintTime += nanoseconds;
+        s_self->m_maxPaintTime = qMax( s_self->m_maxPaintTime, nanoseconds );
+
+        auto iter = s_self->m_windows.find( decoration );
+        if( iter != s_self->m_windows.end() )
+        {
+            ++iter->paints;
+            iter->paintTime += nanoseconds;
+            iter->maxPaintTime = qMax( iter->maxPaintTime, nanoseconds );
+        }
+
+        // update paint rate once per second
+        const qint64 elapsed( s_self->m_rateTimer.elapsed() );
+        if( elapsed >= 1000 )
+        {
+            s_self->m_paintsPerSecond = 1000.0*s_self->m_ratePaints/elapsed;
+            s_self->m_ratePaints = 0;
+            s_self->m_rateTimer.restart();
+        }
+    }
+
+    //__________________________________________________________________
+    void Statistics::recordShadowRegeneration( const Decoration* decoration )
+    {
+        if( !s_self ) return;
+
+        ++s_self->m_shadowRegenerations;
+        auto iter = s_self->m_windows.find( decoration );
+        if( iter != s_self->m_windows.end() ) ++iter->shadowRegenerations;
+    }
+
+    //__________________________________________________________________
+    void Statistics::recordBlurRegionRebuild( const Decoration* decoration )
+    {
+        if( !s_self ) return;
+
+        ++s_self->m_blurRegionRebuilds;
+        auto iter = s_self->m_windows.find( decoration );
+        if( iter != s_self->m_windows.end() ) ++iter->blurRegionRebuilds;
+    }
+
+    //__________________________________________________________________
+    void Statistics::recordExceptionMatch( qint64 nanoseconds )
+    {
+        if( !s_self ) return;
+
+        ++s_self->m_exceptionMatches;
+        s_self->m_exceptionMatchTime += nanoseconds;
+    }
+
+    //__________________________________________________________________
+    void Statistics::recordCacheAccess( Cache cache, bool hit )
+    {
+        if( !s_self ) return;
+
+        if( hit ) ++s_self->m_caches[cache].hits;
+        else ++s_self->m_caches[cache].misses;
+    }
+
+    //__________________________________________________________________
+    double Statistics::paintsPerSecond( void ) const
+    {
+        // the rate is only refreshed on paint, account for idle periods
+        const qint64 elapsed( m_rateTimer.elapsed() );
+        if( elapsed >= 2000 ) return 1000.0*m_ratePaints/elapsed;
+        else return m_paintsPerSecond;
+    }
+
+    //__________________________________________________________________
+    QVariantMap Statistics::cacheHitRatios( void ) const
+    {
+        QVariantMap out;
+        for( int cache = 0; cache < CacheCount; ++cache )
+        {
+            const auto& statistics( m_caches[cache] );
+            const qint64 accesses( statistics.hits + statistics.misses );
+            out.insert( QString::fromLatin1( s_cacheNames[cache] ), accesses ? double( statistics.hits )/accesses : 0.0 );
+        }
+
+        return out;
+    }
+
+    //__________________________________________________________________
+    QVariantMap Statistics::windowStatistics( void ) const
+    {
+        QVariantMap out;
+        for( auto iter = m_windows.constBegin(); iter != m_windows.constEnd(); ++iter )
+        {
+
+            // window ids are not available for wayland clients, fall back to the decoration address
+            const auto client = iter.key()->client();
+            const WId windowId = client ? client->windowId() : 0;
+            const QString key = windowId ?
+                QString::number( windowId ):
+                QStringLiteral( "decoration-0x%1" ).arg( quintptr( iter.key() ), 0, 16 );
+
+            const auto& statistics( iter.value() );
+            QVariantMap window;
+            window.insert( QStringLiteral( "caption" ), client ? client->caption() : QString() );
+            window.insert( QStringLiteral( "paints" ), statistics.paints );
+            window.insert( QStringLiteral( "averagePaintTime" ), statistics.paints ? double( statistics.paintTime )/statistics.paints/1000 : 0.0 );
+            window.insert( QStringLiteral( "maxPaintTime" ), statistics.maxPaintTime/1000 );
+            window.insert( QStringLiteral( "shadowRegenerations" ), statistics.shadowRegenerations );
+            window.insert( QStringLiteral( "blurRegionRebuilds" ), statistics.blurRegionRebuilds );
+            out.insert( key, window );
+
+        }
+
+        return out;
+    }
+
+    //__________________________________________________________________
+    void Statistics::reset( void )
+    {
+        m_paints = 0;
+        m_paintTime = 0;
+        m_maxPaintTime = 0;
+        m_shadowRegenerations = 0;
+        m_blurRegionRebuilds = 0;
+        m_exceptionMatches = 0;
+        m_exceptionMatchTime = 0;
+        for( auto& cache : m_caches ) cache = CacheStatistics();
+
+        m_ratePaints = 0;
+        m_paintsPerSecond = 0;
+        m_rateTimer.restart();
+
+        for( auto iter = m_windows.begin(); iter != m_windows.end(); ++iter )
+        { iter.value() = WindowStatistics(); }
+    }
+
+}
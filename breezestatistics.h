@@ -0,0 +1,209 @@
+#ifndef breezestatistics_h
+#define breezestatistics_h
+
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QVariantMap>
+
+namespace SierraBreeze
+{
+
+    class Decoration;
+
+    //* running performance counters, exported on the session bus
+    /**
+    the object lives as long as at least one decoration exists, and is available
+    as /SierraBreeze/Stats on kwin's session bus connection.
+    All record methods are no-ops when no decoration is alive.
+    */
+    class Statistics: public QObject
+    {
+
+        Q_OBJECT
+        Q_CLASSINFO( "D-Bus Interface", "org.kde.SierraBreeze.Stats" )
+
+        Q_PROPERTY( double paintsPerSecond READ paintsPerSecond )
+        Q_PROPERTY( double averagePaintTime READ averagePaintTime )
+        Q_PROPERTY( qlonglong maxPaintTime READ maxPaintTime )
+        Q_PROPERTY( qlonglong paints READ paints )
+        Q_PROPERTY( qlonglong shadowRegenerations READ shadowRegenerations )
+        Q_PROPERTY( qlonglong blurRegionRebuilds READ blurRegionRebuilds )
+        Q_PROPERTY( qlonglong exceptionMatches READ exceptionMatches )
+        Q_PROPERTY( qlonglong exceptionMatchTime READ exceptionMatchTime )
+        Q_PROPERTY( int decorationCount READ decorationCount )
+
+        public:
+
+        //* caches for which hit ratios are reported
+        enum Cache
+        {
+            ShadowCache,
+            ButtonSpriteCache,
+            CacheCount
+        };
+
+        //*@name decoration registration
+        //@{
+        static void registerDecoration( const Decoration* );
+        static void unregisterDecoration( const Decoration* );
+        //@}
+
+        //*@name recording
+        //@{
+        static void recordPaint( const Decoration*, qint64 nanoseconds );
+        static void recordShadowRegeneration( const Decoration* );
+        static void recordBlurRegionRebuild( const Decoration* );
+        static void recordExceptionMatch( qint64 nanoseconds );
+        static void recordCacheAccess( Cache, bool hit );
+        //@}
+
+        //* scoped paint timer
+        class PaintTimer
+        {
+            public:
+
+            //* constructor
+            explicit PaintTimer( const Decoration* decoration ):
+                m_decoration( decoration )
+            { m_timer.start(); }
+
+            //* destructor
+            ~PaintTimer()
+            { recordPaint( m_decoration, m_timer.nsecsElapsed() ); }
+
+            private:
+
+            Q_DISABLE_COPY( PaintTimer )
+
+            const Decoration* m_decoration;
+            QElapsedTimer m_timer;
+
+        };
+
+        //*@name exported properties
+        //@{
+
+        //* paints per second, over the last second
+        double paintsPerSecond( void ) const;
+
+        //* average paint time (microseconds)
+        double averagePaintTime( void ) const
+        { return m_paints ? double( m_paintTime )/m_paints/1000 : 0; }
+
+        //* max paint time (microseconds)
+        qlonglong maxPaintTime( void ) const
+        { return m_maxPaintTime/1000; }
+
+        //* total paints
+        qlonglong paints( void ) const
+        { return m_paints; }
+
+        //* shadow regenerations
+        qlonglong shadowRegenerations( void ) const
+        { return m_shadowRegenerations; }
+
+        //* blur region rebuilds
+        qlonglong blurRegionRebuilds( void ) const
+        { return m_blurRegionRebuilds; }
+
+        //* exception list evaluations
+        qlonglong exceptionMatches( void ) const
+        { return m_exceptionMatches; }
+
+        //* total time spent evaluating exceptions (microseconds)
+        qlonglong exceptionMatchTime( void ) const
+        { return m_exceptionMatchTime/1000; }
+
+        //* live decorations
+        int decorationCount( void ) const
+        { return m_windows.size(); }
+
+        //@}
+
+        public Q_SLOTS:
+
+        //* hit ratio for each cache, keyed by cache name
+        Q_SCRIPTABLE QVariantMap cacheHitRatios( void ) const;
+
+        //* per window counters, keyed by window id
+        Q_SCRIPTABLE QVariantMap windowStatistics( void ) const;
+
+        //* reset all counters
+        Q_SCRIPTABLE void reset( void );
+
+        private:
+
+        //* constructor
+        Statistics();
+
+        //* destructor
+        ~Statistics() override;
+
+        //* per window counters
+        struct WindowStatistics
+        {
+            qint64 paints = 0;
+            qint64 paintTime = 0;
+            qint64 maxPaintTime = 0;
+            qint64 shadowRegenerations = 0;
+            qint64 blurRegionRebuilds = 0;
+        };
+
+        //* per cache counters
+        struct CacheStatistics
+        {
+            qint64 hits = 0;
+            qint64 misses = 0;
+        };
+
+        //*@name global counters
+        //@{
+        qint64 m_paints = 0;
+        qint64 m_paintTime = 0;
+        qint64 m_maxPaintTime = 0;
+        qint64 m_shadowRegenerations = 0;
+        qint64 m_blurRegionRebuilds = 0;
+        qint64 m_exceptionMatches = 0;
+        qint64 m_exceptionMatchTime = 0;
+        CacheStatistics m_caches[ CacheCount ];
+        //@}
+
+        //*@name paint rate
+        //@{
+        QElapsedTimer m_rateTimer;
+        qint64 m_ratePaints = 0;
+        double m_paintsPerSecond = 0;
+        //@}
+
+        //* per window counters
+        QHash<const Decoration*, WindowStatistics> m_windows;
+
+        //* singleton
+        static Statistics *s_self;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breezetracing.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <chrono>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace SierraBreeze
+{
+
+    namespace
+    {
+
+        //* chrome trace writer
+        class TraceWriter
+        {
+
+            public:
+
+            //* singleton
+            static TraceWriter& self()
+            {
+                static TraceWriter writer;
+                return writer;
+            }
+
+            //* true if events are recorded
+            bool isEnabled( void ) const
+            { return m_enabled; }
+
+            //* append complete event
+            void addCompleteEvent( const char* name, qint64 start, qint64 duration )
+            {
+
+                const QByteArray event = QByteArrayLiteral( "{\"name\":\"" ) + name
+                    + QByteArrayLiteral( "\",\"cat\":\"sierrabreeze\",\"ph\":\"X\",\"ts\":" ) + QByteArray::number( start )
+                    + QByteArrayLiteral( ",\"dur\":" ) + QByteArray::number( duration )
+                    + QByteArrayLiteral( ",\"pid\":" ) + QByteArray::number( m_pid )
+                    + QByteArrayLiteral( ",\"tid\":" ) + QByteArray::number( qint64( syscall( SYS_gettid ) ) )
+                    + '}';
+
+                QMutexLocker locker( &m_mutex );
+                m_buffer += ",\n";
+                m_buffer += event;
+                if( m_buffer.size() > s_flushSize ) flush();
+
+            }
+
+            private:
+
+            //* constructor
+            TraceWriter():
+                m_pid( getpid() )
+            {
+                const QString fileName( qEnvironmentVariable( "SIERRABREEZE_TRACE_FILE" ) );
+                if( fileName.isEmpty() ) return;
+
+                m_file.setFileName( fileName );
+                if( !m_file.open( QIODevice::WriteOnly|QIODevice::Truncate ) ) return;
+
+                // array format. Trace viewers accept a missing closing bracket, should kwin crash
+                m_file.write( "[\n{\"name\":\"process_labels\",\"ph\":\"M\",\"pid\":" + QByteArray::number( m_pid ) + ",\"args\":{\"labels\":\"SierraBreeze\"}}" );
+                m_enabled = true;
+            }
+
+            //* destructor
+            ~TraceWriter()
+            {
+                if( !m_enabled ) return;
+                flush();
+                m_file.write( "\n]\n" );
+                m_file.close();
+            }
+
+            //* write pending events
+            void flush( void )
+            {
+                m_file.write( m_buffer );
+                m_file.flush();
+                m_buffer.clear();
+            }
+
+            //* buffer size above which events are written to disk
+            static constexpr int s_flushSize = 64*1024;
+
+            //* output file
+            QFile m_file;
+
+            //* pending events
+            QByteArray m_buffer;
+
+            //* lock
+            QMutex m_mutex;
+
+            //* process id
+            qint64 m_pid;
+
+            //* enabled state
+            bool m_enabled = false;
+
+        };
+
+        //* current monotonic time, in microseconds
+        qint64 now( void )
+        { return std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count(); }
+
+    }
+
+    //__________________________________________________________________
+    TraceScope::TraceScope( const char* name ):
+        m_name( name ),
+        m_start( TraceWriter::self().isEnabled() ? now() : -1 )
+    {}
+
+    //__________________________________________________________________
+    TraceScope::~TraceScope()
+    {
+        if( m_start < 0 ) return;
+        TraceWriter::self().addCompleteEvent( m_name, m_start, now() - m_start );
+    }
+
+}
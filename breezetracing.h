@@ -0,0 +1,72 @@
+#ifndef breezetracing_h
+#define breezetracing_h
+
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config-breeze.h"
+
+#if SIERRABREEZE_TRACING
+
+#include <QtGlobal>
+
+namespace SierraBreeze
+{
+
+    //* scoped trace event
+    /**
+    events are written as chrome trace "complete" events to the file named by the
+    SIERRABREEZE_TRACE_FILE environment variable. Nothing is recorded when it is not set.
+    Timestamps use the monotonic clock, so that they line up with kwin's own traces.
+    */
+    class TraceScope
+    {
+
+        public:
+
+        //* constructor
+        explicit TraceScope( const char* name );
+
+        //* destructor
+        ~TraceScope();
+
+        private:
+
+        Q_DISABLE_COPY( TraceScope )
+
+        //* event name. Must be a string literal
+        const char* m_name;
+
+        //* start time (microseconds), negative if tracing is disabled
+        qint64 m_start;
+
+    };
+
+}
+
+#define BREEZE_TRACE_SCOPE( name ) SierraBreeze::TraceScope traceScope( name )
+
+#else
+
+#define BREEZE_TRACE_SCOPE( name )
+
+#endif
+
+#endif
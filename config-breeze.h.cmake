@@ -25,4 +25,17 @@
 /* Define to 1 if XCB libraries are found */
 #define BREEZE_HAVE_X11 0
 
+/* Define to 1 to count heap allocations on the paint path. Tests may enable it on their own */
+#ifndef SIERRABREEZE_ALLOCATION_COUNTING
+#cmakedefine01 SIERRABREEZE_ALLOCATION_COUNTING
+#endif
+
+/* Define to 1 to record chrome trace events */
+#cmakedefine01 SIERRABREEZE_TRACING
+
+/* Define to 1 to compare optimized paint paths against the reference ones. Tests may enable it on their own */
+#ifndef SIERRABREEZE_PAINT_VERIFICATION
+#cmakedefine01 SIERRABREEZE_PAINT_VERIFICATION
+#endif
+
 #endif
@@ -27,10 +27,14 @@
 #include "breezeexceptionlist.h"
 #include "breezesettings.h"
 
+#include <KConfigGroup>
 #include <KLocalizedString>
 
 #include <QDBusConnection>
 #include <QDBusMessage>
+#include <QDir>
+#include <QSet>
+#include <QStandardPaths>
 
 namespace SierraBreeze
 {
@@ -38,13 +42,26 @@ namespace SierraBreeze
     //_________________________________________________________
     ConfigWidget::ConfigWidget( QObject* parent, const KPluginMetaData &data, const QVariantList &):
         KCModule(parent, data),
-        m_configuration( KSharedConfig::openConfig( QStringLiteral( "sierrabreezerc" ) ) ),
+        m_configuration( KSharedConfig::openConfig( QStringLiteral( "breezerc" ) ) ),
+        m_previewSettings( new InternalSettings() ),
         m_changed( false )
     {
 
         // configuration
         m_ui.setupUi(widget());
 
+        // glyph sets, installed as sierrabreeze/glyphs/<name> in the generic data location
+        m_ui.glyphSet->addItem( i18n( "Built-in" ), QString() );
+        QStringList glyphSets;
+        const QStringList glyphDirectories( QStandardPaths::locateAll( QStandardPaths::GenericDataLocation, QStringLiteral( "sierrabreeze/glyphs" ), QStandardPaths::LocateDirectory ) );
+        for( const QString& directory : glyphDirectories )
+        { glyphSets.append( QDir( directory ).entryList( QDir::Dirs|QDir::NoDotAndDotDot ) ); }
+
+        glyphSets.removeDuplicates();
+        glyphSets.sort();
+        for( const QString& glyphSet : std::as_const( glyphSets ) )
+        { m_ui.glyphSet->addItem( glyphSet, glyphSet ); }
+
         // track ui changes
         connect( m_ui.titleAlignment, SIGNAL(currentIndexChanged(int)), SLOT(updateChanged()) );
         // connect( m_ui.buttonSize, SIGNAL(currentIndexChanged(int)), SLOT(updateChanged()) );
@@ -61,6 +78,7 @@ namespace SierraBreeze
         connect( m_ui.buttonSize, SIGNAL(valueChanged(int)), SLOT(updateChanged()) );
         connect( m_ui.buttonSpacing, SIGNAL(valueChanged(int)), SLOT(updateChanged()) );
         connect( m_ui.buttonHPadding, SIGNAL(valueChanged(int)), SLOT(updateChanged()) );
+        connect( m_ui.glyphSet, SIGNAL(currentIndexChanged(int)), SLOT(updateChanged()) );
 
         connect( m_ui.buttonCloseActiveColor, SIGNAL(changed(QColor)), SLOT(updateChanged()) );
         connect( m_ui.buttonCloseInactiveColor, SIGNAL(changed(QColor)), SLOT(updateChanged()) );
@@ -80,6 +98,9 @@ namespace SierraBreeze
         // track animations changes
         connect( m_ui.animationsEnabled, SIGNAL(clicked()), SLOT(updateChanged()) );
         connect( m_ui.animationsDuration, SIGNAL(valueChanged(int)), SLOT(updateChanged()) );
+        connect( m_ui.maxConcurrentAnimations, SIGNAL(valueChanged(int)), SLOT(updateChanged()) );
+        connect( m_ui.reducedMotionUnderLoad, SIGNAL(clicked()), SLOT(updateChanged()) );
+        connect( m_ui.animationFrameBudget, SIGNAL(valueChanged(int)), SLOT(updateChanged()) );
 
         // track shadows changes
         connect( m_ui.shadowSize, SIGNAL(valueChanged(int)), SLOT(updateChanged()) );
@@ -109,11 +130,15 @@ namespace SierraBreeze
         m_ui.drawBackgroundGradient->setChecked( m_internalSettings->drawBackgroundGradient() );
         m_ui.animationsEnabled->setChecked( m_internalSettings->animationsEnabled() );
         m_ui.animationsDuration->setValue( m_internalSettings->animationsDuration() );
+        m_ui.maxConcurrentAnimations->setValue( m_internalSettings->maxConcurrentAnimations() );
+        m_ui.reducedMotionUnderLoad->setChecked( m_internalSettings->reducedMotionUnderLoad() );
+        m_ui.animationFrameBudget->setValue( m_internalSettings->animationFrameBudget() );
         m_ui.opacitySpinBox->setValue( m_internalSettings->backgroundOpacity() );
         m_ui.drawTitleBarSeparator->setChecked( m_internalSettings->drawTitleBarSeparator() );
         m_ui.buttonSize->setValue( m_internalSettings->buttonSize() );
         m_ui.buttonSpacing->setValue( m_internalSettings->buttonSpacing() );
         m_ui.buttonHPadding->setValue( m_internalSettings->buttonHPadding() );
+        m_ui.glyphSet->setCurrentIndex( qMax( 0, m_ui.glyphSet->findData( m_internalSettings->glyphSet() ) ) );
         m_ui.matchColorForTitleBar->setChecked( m_internalSettings->matchColorForTitleBar() );
         m_ui.cornerRadius->setValue(m_internalSettings->cornerRadius());
 
@@ -138,13 +163,104 @@ namespace SierraBreeze
         m_ui.shadowColor->setColor( m_internalSettings->shadowColor() );
 
         // load exceptions
+        migrateExceptions();
         ExceptionList exceptions;
         exceptions.readConfig( m_configuration );
         m_ui.exceptions->setExceptions( exceptions.get() );
+        updatePreview();
         setChanged( false );
 
     }
 
+    //_________________________________________________________
+    void ConfigWidget::migrateExceptions( void )
+    {
+
+        /*
+        exceptions used to be saved in sierrabreezerc, which the decoration never read.
+        Those breezerc lacks are appended, and the old file is only marked, so that exceptions removed afterwards stay removed
+        */
+        KSharedConfig::Ptr legacy( KSharedConfig::openConfig( QStringLiteral( "sierrabreezerc" ), KConfig::NoGlobals ) );
+        KConfigGroup migration( legacy, QStringLiteral( "Migration" ) );
+        if( !legacy->hasGroup( ExceptionList::exceptionGroupName( 0 ) ) || migration.readEntry( "ExceptionsMigrated", false ) ) return;
+
+        const auto key = []( const InternalSettingsPtr& exception )
+        { return QStringLiteral( "%1|%2|%3" ).arg( exception->exceptionType() ).arg( exception->exceptionPatternKind() ).arg( exception->exceptionPattern() ); };
+
+        ExceptionList current;
+        current.readConfig( m_configuration );
+        InternalSettingsList exceptions( current.get() );
+
+        QSet<QString> keys;
+        for( const auto& exception : std::as_const( exceptions ) ) keys.insert( key( exception ) );
+
+        ExceptionList previous;
+        previous.readConfig( legacy );
+        for( const auto& exception : previous.get() )
+        { if( !keys.contains( key( exception ) ) ) exceptions.append( exception ); }
+
+        if( exceptions.size() > current.get().size() && ExceptionList( exceptions ).writeConfig( m_configuration ) )
+        { m_configuration->sync(); }
+
+        migration.writeEntry( "ExceptionsMigrated", true );
+        legacy->sync();
+
+    }
+
+    //_________________________________________________________
+    void ConfigWidget::storeSettings( InternalSettingsPtr settings ) const
+    {
+
+        settings->setTitleAlignment( m_ui.titleAlignment->currentIndex() );
+        // settings->setButtonSize( m_ui.buttonSize->currentIndex() );
+        settings->setOutlineCloseButton( m_ui.outlineCloseButton->isChecked() );
+        settings->setDrawBorderOnMaximizedWindows( m_ui.drawBorderOnMaximizedWindows->isChecked() );
+        settings->setDrawSizeGrip( m_ui.drawSizeGrip->isChecked() );
+        settings->setOpaqueTitleBar( m_ui.opaqueTitleBar->isChecked() );
+        settings->setDrawBackgroundGradient( m_ui.drawBackgroundGradient->isChecked() );
+        settings->setAnimationsEnabled( m_ui.animationsEnabled->isChecked() );
+        settings->setAnimationsDuration( m_ui.animationsDuration->value() );
+        settings->setMaxConcurrentAnimations( m_ui.maxConcurrentAnimations->value() );
+        settings->setReducedMotionUnderLoad( m_ui.reducedMotionUnderLoad->isChecked() );
+        settings->setAnimationFrameBudget( m_ui.animationFrameBudget->value() );
+        settings->setBackgroundOpacity(m_ui.opacitySpinBox->value());
+        settings->setDrawTitleBarSeparator(m_ui.drawTitleBarSeparator->isChecked());
+        settings->setMatchColorForTitleBar( m_ui.matchColorForTitleBar->isChecked() );
+        settings->setCornerRadius(m_ui.cornerRadius->value());
+
+        settings->setButtonSize( m_ui.buttonSize->value() );
+        settings->setButtonSpacing( m_ui.buttonSpacing->value() );
+        settings->setButtonHPadding( m_ui.buttonHPadding->value() );
+        settings->setGlyphSet( m_ui.glyphSet->currentData().toString() );
+
+        settings->setButtonCloseActiveColor( m_ui.buttonCloseActiveColor->color() );
+        settings->setButtonCloseInactiveColor( m_ui.buttonCloseInactiveColor->color() );
+        settings->setButtonMaximizeActiveColor( m_ui.buttonMaximizeActiveColor->color() );
+        settings->setButtonMaximizeInactiveColor( m_ui.buttonMaximizeInactiveColor->color() );
+        settings->setButtonMinimizeActiveColor( m_ui.buttonMinimizeActiveColor->color() );
+        settings->setButtonMinimizeInactiveColor( m_ui.buttonMinimizeInactiveColor->color() );
+        settings->setButtonOnAllDesktopsActiveColor( m_ui.buttonOnAllDesktopsActiveColor->color() );
+        settings->setButtonOnAllDesktopsInactiveColor( m_ui.buttonOnAllDesktopsInactiveColor->color() );
+        settings->setButtonShadeActiveColor( m_ui.buttonShadeActiveColor->color() );
+        settings->setButtonShadeInactiveColor( m_ui.buttonShadeInactiveColor->color() );
+        settings->setButtonKeepBelowActiveColor( m_ui.buttonKeepBelowActiveColor->color() );
+        settings->setButtonKeepBelowInactiveColor( m_ui.buttonKeepBelowInactiveColor->color() );
+        settings->setButtonKeepAboveActiveColor( m_ui.buttonKeepAboveActiveColor->color() );
+        settings->setButtonKeepAboveInactiveColor( m_ui.buttonKeepAboveInactiveColor->color() );
+
+        settings->setShadowSize( m_ui.shadowSize->value() );
+        settings->setShadowStrength( qRound( qreal(m_ui.shadowStrength->value()*255)/100 ) );
+        settings->setShadowColor( m_ui.shadowColor->color() );
+
+    }
+
+    //_________________________________________________________
+    void ConfigWidget::updatePreview( void )
+    {
+        storeSettings( m_previewSettings );
+        m_ui.preview->setSettings( m_previewSettings );
+    }
+
     //_________________________________________________________
     void ConfigWidget::save( void )
     {
@@ -154,61 +270,40 @@ namespace SierraBreeze
         m_internalSettings->load();
 
         // apply modifications from ui
-        m_internalSettings->setTitleAlignment( m_ui.titleAlignment->currentIndex() );
-        // m_internalSettings->setButtonSize( m_ui.buttonSize->currentIndex() );
-        m_internalSettings->setOutlineCloseButton( m_ui.outlineCloseButton->isChecked() );
-        m_internalSettings->setDrawBorderOnMaximizedWindows( m_ui.drawBorderOnMaximizedWindows->isChecked() );
-        m_internalSettings->setDrawSizeGrip( m_ui.drawSizeGrip->isChecked() );
-        m_internalSettings->setOpaqueTitleBar( m_ui.opaqueTitleBar->isChecked() );
-        m_internalSettings->setDrawBackgroundGradient( m_ui.drawBackgroundGradient->isChecked() );
-        m_internalSettings->setAnimationsEnabled( m_ui.animationsEnabled->isChecked() );
-        m_internalSettings->setAnimationsDuration( m_ui.animationsDuration->value() );
-        m_internalSettings->setBackgroundOpacity(m_ui.opacitySpinBox->value());
-        m_internalSettings->setDrawTitleBarSeparator(m_ui.drawTitleBarSeparator->isChecked());
-        m_internalSettings->setMatchColorForTitleBar( m_ui.matchColorForTitleBar->isChecked() );
-        m_internalSettings->setCornerRadius(m_ui.cornerRadius->value());
-
-        m_internalSettings->setButtonSize( m_ui.buttonSize->value() );
-        m_internalSettings->setButtonSpacing( m_ui.buttonSpacing->value() );
-        m_internalSettings->setButtonHPadding( m_ui.buttonHPadding->value() );
-
-        m_internalSettings->setButtonCloseActiveColor( m_ui.buttonCloseActiveColor->color() );
-        m_internalSettings->setButtonCloseInactiveColor( m_ui.buttonCloseInactiveColor->color() );
-        m_internalSettings->setButtonMaximizeActiveColor( m_ui.buttonMaximizeActiveColor->color() );
-        m_internalSettings->setButtonMaximizeInactiveColor( m_ui.buttonMaximizeInactiveColor->color() );
-        m_internalSettings->setButtonMinimizeActiveColor( m_ui.buttonMinimizeActiveColor->color() );
-        m_internalSettings->setButtonMinimizeInactiveColor( m_ui.buttonMinimizeInactiveColor->color() );
-        m_internalSettings->setButtonOnAllDesktopsActiveColor( m_ui.buttonOnAllDesktopsActiveColor->color() );
-        m_internalSettings->setButtonOnAllDesktopsInactiveColor( m_ui.buttonOnAllDesktopsInactiveColor->color() );
-        m_internalSettings->setButtonShadeActiveColor( m_ui.buttonShadeActiveColor->color() );
-        m_internalSettings->setButtonShadeInactiveColor( m_ui.buttonShadeInactiveColor->color() );
-        m_internalSettings->setButtonKeepBelowActiveColor( m_ui.buttonKeepBelowActiveColor->color() );
-        m_internalSettings->setButtonKeepBelowInactiveColor( m_ui.buttonKeepBelowInactiveColor->color() );
-        m_internalSettings->setButtonKeepAboveActiveColor( m_ui.buttonKeepAboveActiveColor->color() );
-        m_internalSettings->setButtonKeepAboveInactiveColor( m_ui.buttonKeepAboveInactiveColor->color() );
-
-        m_internalSettings->setShadowSize( m_ui.shadowSize->value() );
-        m_internalSettings->setShadowStrength( qRound( qreal(m_ui.shadowStrength->value()*255)/100 ) );
-        m_internalSettings->setShadowColor( m_ui.shadowColor->color() );
-
-        // save configuration
-        m_internalSettings->save();
-
-        // get list of exceptions and write
+        storeSettings( m_internalSettings );
+
+        // write the entries that differ from the loaded values. Settings and exceptions share the configuration object
+        QStringList changedKeys;
+        const auto items( m_internalSettings->items() );
+        for( KConfigSkeletonItem* item : items )
+        {
+            if( !item->isSaveNeeded() ) continue;
+            changedKeys.append( item->key() );
+            item->writeConfig( m_configuration.data() );
+        }
+
+        // get list of exceptions and write those that changed
         InternalSettingsList exceptions( m_ui.exceptions->exceptions() );
-        ExceptionList( exceptions ).writeConfig( m_configuration );
+        const bool exceptionsChanged( ExceptionList( exceptions ).writeConfig( m_configuration ) );
 
-        // sync configuration
-        m_configuration->sync();
+        // write the file once, so that the decoration is notified of a single change
+        if( !changedKeys.isEmpty() || exceptionsChanged ) m_configuration->sync();
         setChanged( false );
 
-        // needed to tell kwin to reload when running from external kcmshell
+        if( changedKeys.isEmpty() && !exceptionsChanged ) return;
+
+        // tell the decoration plugin what changed, rather than reloading all of kwin
         {
-            QDBusMessage message = QDBusMessage::createSignal("/KWin", "org.kde.KWin", "reloadConfig");
-            QDBusConnection::sessionBus().send(message);
+            QDBusMessage message( QDBusMessage::createSignal( QStringLiteral( "/SierraBreeze" ), QStringLiteral( "org.kde.SierraBreeze" ), QStringLiteral( "reloadConfig" ) ) );
+            message << changedKeys << exceptionsChanged;
+            QDBusConnection::sessionBus().send( message );
         }
 
         // needed for breeze style to reload shadows
+        const bool shadowChanged( changedKeys.contains( QStringLiteral( "ShadowSize" ) ) ||
+            changedKeys.contains( QStringLiteral( "ShadowStrength" ) ) ||
+            changedKeys.contains( QStringLiteral( "ShadowColor" ) ) );
+        if( shadowChanged )
         {
             QDBusMessage message( QDBusMessage::createSignal("/BreezeDecoration",  "org.kde.Breeze.Style", "reparseConfiguration") );
             QDBusConnection::sessionBus().send(message);
@@ -233,6 +328,9 @@ namespace SierraBreeze
         m_ui.drawBackgroundGradient->setChecked( m_internalSettings->drawBackgroundGradient() );
         m_ui.animationsEnabled->setChecked( m_internalSettings->animationsEnabled() );
         m_ui.animationsDuration->setValue( m_internalSettings->animationsDuration() );
+        m_ui.maxConcurrentAnimations->setValue( m_internalSettings->maxConcurrentAnimations() );
+        m_ui.reducedMotionUnderLoad->setChecked( m_internalSettings->reducedMotionUnderLoad() );
+        m_ui.animationFrameBudget->setValue( m_internalSettings->animationFrameBudget() );
         m_ui.opacitySpinBox->setValue( m_internalSettings->backgroundOpacity() );
         m_ui.drawTitleBarSeparator->setChecked( m_internalSettings->drawTitleBarSeparator() );
         m_ui.cornerRadius->setValue(m_internalSettings->cornerRadius());
@@ -240,6 +338,7 @@ namespace SierraBreeze
         m_ui.buttonSize->setValue( m_internalSettings->buttonSize() );
         m_ui.buttonSpacing->setValue( m_internalSettings->buttonSpacing() );
         m_ui.buttonHPadding->setValue( m_internalSettings->buttonHPadding() );
+        m_ui.glyphSet->setCurrentIndex( qMax( 0, m_ui.glyphSet->findData( m_internalSettings->glyphSet() ) ) );
 
         m_ui.buttonCloseActiveColor->setColor( m_internalSettings->buttonCloseActiveColor() );
         m_ui.buttonCloseInactiveColor->setColor( m_internalSettings->buttonCloseInactiveColor() );
@@ -270,6 +369,8 @@ namespace SierraBreeze
         // check configuration
         if( !m_internalSettings ) return;
 
+        updatePreview();
+
         // track modifications
         bool modified( false );
 
@@ -285,6 +386,7 @@ namespace SierraBreeze
         else if( m_ui.buttonSize->value() != m_internalSettings->buttonSize() ) modified = true;
         else if( m_ui.buttonSpacing->value() != m_internalSettings->buttonSpacing() ) modified = true;
         else if( m_ui.buttonHPadding->value() != m_internalSettings->buttonHPadding() ) modified = true;
+        else if( m_ui.glyphSet->currentData().toString() != m_internalSettings->glyphSet() ) modified = true;
         else if( m_ui.buttonCloseActiveColor->color() != m_internalSettings->buttonCloseActiveColor() ) modified = true;
         else if( m_ui.buttonCloseInactiveColor->color() != m_internalSettings->buttonCloseInactiveColor() ) modified = true;
         else if( m_ui.buttonMaximizeActiveColor->color() != m_internalSettings->buttonMaximizeActiveColor() ) modified = true;
@@ -304,6 +406,9 @@ namespace SierraBreeze
         // animations
         else if( m_ui.animationsEnabled->isChecked() !=  m_internalSettings->animationsEnabled() ) modified = true;
         else if( m_ui.animationsDuration->value() != m_internalSettings->animationsDuration() ) modified = true;
+        else if( m_ui.maxConcurrentAnimations->value() != m_internalSettings->maxConcurrentAnimations() ) modified = true;
+        else if( m_ui.reducedMotionUnderLoad->isChecked() != m_internalSettings->reducedMotionUnderLoad() ) modified = true;
+        else if( m_ui.animationFrameBudget->value() != m_internalSettings->animationFrameBudget() ) modified = true;
 
         // shadows
         else if( m_ui.shadowSize->value() !=  m_internalSettings->shadowSize() ) modified = true;
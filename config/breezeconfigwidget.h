@@ -72,8 +72,17 @@ namespace SierraBreeze
         //* set changed state
         void setChanged( bool );
 
+        //* copy ui values into settings
+        void storeSettings( InternalSettingsPtr ) const;
+
+        //* show ui values in the preview
+        void updatePreview( void );
+
         private:
 
+        //* copy, once, the exceptions that earlier versions saved in sierrabreezerc
+        void migrateExceptions( void );
+
         //* ui
         Ui_BreezeConfigurationUI m_ui;
 
@@ -83,6 +92,9 @@ namespace SierraBreeze
         //* internal exception
         InternalSettingsPtr m_internalSettings;
 
+        //* settings shown in the preview, not saved
+        InternalSettingsPtr m_previewSettings;
+
         //* changed state
         bool m_changed;
 
@@ -25,6 +25,13 @@
 
 #include "breezeexceptiondialog.h"
 #include "breezedetectwidget.h"
+#include "breezeexceptionmatcher.h"
+
+#include <KLocalizedString>
+
+#include <QLocale>
+#include <QTimer>
+#include <QtConcurrent>
 
 namespace SierraBreeze
 {
@@ -46,6 +53,7 @@ namespace SierraBreeze
 
         // connections
         connect( m_ui.exceptionType, SIGNAL(currentIndexChanged(int)), SLOT(updateChanged()) );
+        connect( m_ui.patternKind, SIGNAL(currentIndexChanged(int)), SLOT(updateChanged()) );
         connect( m_ui.exceptionEditor, &QLineEdit::textChanged, this, &ExceptionDialog::updateChanged);
         connect( m_ui.borderSizeComboBox, SIGNAL(currentIndexChanged(int)), SLOT(updateChanged()) );
 
@@ -53,6 +61,17 @@ namespace SierraBreeze
         { connect(iter.value(), &QAbstractButton::clicked, this, &ExceptionDialog::updateChanged); }
 
         connect(m_ui.hideTitleBar, &QAbstractButton::clicked, this, &ExceptionDialog::updateChanged);
+
+        // pattern analysis
+        m_analysisTimer = new QTimer( this );
+        m_analysisTimer->setSingleShot( true );
+        m_analysisTimer->setInterval( 250 );
+        connect( m_analysisTimer, &QTimer::timeout, this, &ExceptionDialog::analyzePattern );
+        connect( &m_analysisWatcher, &QFutureWatcher<PatternAnalyzer::Report>::finished, this, &ExceptionDialog::updatePatternAnalysis );
+
+        connect( m_ui.exceptionEditor, &QLineEdit::textChanged, m_analysisTimer, qOverload<>( &QTimer::start ) );
+        connect( m_ui.exceptionType, SIGNAL(currentIndexChanged(int)), m_analysisTimer, SLOT(start()) );
+        connect( m_ui.patternKind, SIGNAL(currentIndexChanged(int)), m_analysisTimer, SLOT(start()) );
     }
 
     //___________________________________________
@@ -64,6 +83,7 @@ namespace SierraBreeze
 
         // type
         m_ui.exceptionType->setCurrentIndex(m_exception->exceptionType() );
+        m_ui.patternKind->setCurrentIndex( m_exception->exceptionPatternKind() );
         m_ui.exceptionEditor->setText( m_exception->exceptionPattern() );
         m_ui.borderSizeComboBox->setCurrentIndex( m_exception->borderSize() );
         m_ui.hideTitleBar->setChecked( m_exception->hideTitleBar() );
@@ -80,6 +100,7 @@ namespace SierraBreeze
     void ExceptionDialog::save( void )
     {
         m_exception->setExceptionType( m_ui.exceptionType->currentIndex() );
+        m_exception->setExceptionPatternKind( m_ui.patternKind->currentIndex() );
         m_exception->setExceptionPattern( m_ui.exceptionEditor->text() );
         m_exception->setBorderSize( m_ui.borderSizeComboBox->currentIndex() );
         m_exception->setHideTitleBar( m_ui.hideTitleBar->isChecked() );
@@ -100,6 +121,7 @@ namespace SierraBreeze
     {
         bool modified( false );
         if( m_exception->exceptionType() != m_ui.exceptionType->currentIndex() ) modified = true;
+        else if( m_exception->exceptionPatternKind() != m_ui.patternKind->currentIndex() ) modified = true;
         else if( m_exception->exceptionPattern() != m_ui.exceptionEditor->text() ) modified = true;
         else if( m_exception->borderSize() != m_ui.borderSizeComboBox->currentIndex() ) modified = true;
         else if( m_exception->hideTitleBar() != m_ui.hideTitleBar->isChecked() ) modified = true;
@@ -166,4 +188,63 @@ namespace SierraBreeze
 
     }
 
+    //___________________________________________
+    void ExceptionDialog::analyzePattern( void )
+    {
+
+        // one analysis at a time. The latest pattern is analyzed once the running one is done
+        if( m_analysisWatcher.isRunning() )
+        {
+            m_analysisTimer->start();
+            return;
+        }
+
+        // exact names are looked up, they have no matching cost
+        const QString pattern( m_ui.exceptionEditor->text() );
+        if( pattern.isEmpty() || m_ui.patternKind->currentIndex() == InternalSettings::PatternLiteral )
+        {
+            m_ui.patternAnalysis->clear();
+            return;
+        }
+
+        const QString expression( ExceptionMatcher::regularExpression( pattern, m_ui.patternKind->currentIndex() ) );
+        m_analysisWatcher.setFuture( QtConcurrent::run( &PatternAnalyzer::analyze, expression, m_ui.exceptionType->currentIndex() ) );
+
+    }
+
+    //___________________________________________
+    void ExceptionDialog::updatePatternAnalysis( void )
+    {
+
+        const PatternAnalyzer::Report report( m_analysisWatcher.result() );
+        if( !report.valid )
+        {
+            m_ui.patternAnalysis->setText( i18n( "Invalid regular expression: %1", report.error ) );
+            return;
+        }
+
+        QStringList lines;
+        lines.append( i18n( "Estimated matching cost: %1 µs per window, up to %2 µs.",
+            QLocale().toString( report.cost/1000.0, 'f', 2 ),
+            QLocale().toString( report.worstCost/1000.0, 'f', 2 ) ) );
+
+        if( report.hazards & PatternAnalyzer::NestedQuantifier )
+        { lines.append( i18n( "Nested repetitions, as in (a+)+, may cause catastrophic backtracking." ) ); }
+
+        if( report.hazards & PatternAnalyzer::OverlappingAlternation )
+        { lines.append( i18n( "Repeated alternatives that can match the same text, as in (a|ab)*, may cause catastrophic backtracking." ) ); }
+
+        if( report.hazards & PatternAnalyzer::AdjacentWildcards )
+        { lines.append( i18n( "Consecutive wildcards, as in .*.*, make matching slow on long titles." ) ); }
+
+        if( report.hazards & PatternAnalyzer::BackReference )
+        { lines.append( i18n( "Back references prevent most regular expression optimizations." ) ); }
+
+        if( report.isOverBudget() )
+        { lines.append( i18n( "This pattern is over the matching budget and may be ignored by the decoration." ) ); }
+
+        m_ui.patternAnalysis->setText( lines.join( QLatin1Char( '\n' ) ) );
+
+    }
+
 }
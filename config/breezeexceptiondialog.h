@@ -27,10 +27,14 @@
 
 #include "ui_breezeexceptiondialog.h"
 #include "breeze.h"
+#include "breezepatternanalyzer.h"
 
 #include <QCheckBox>
+#include <QFutureWatcher>
 #include <QMap>
 
+class QTimer;
+
 namespace SierraBreeze
 {
 
@@ -88,6 +92,12 @@ namespace SierraBreeze
         //* read properties of selected window
         void readWindowProperties( bool );
 
+        //* start analysis of the current pattern, in a worker thread
+        void analyzePattern( void );
+
+        //* show analysis result
+        void updatePatternAnalysis( void );
+
         private:
 
         //* map mask and checkbox
@@ -104,6 +114,12 @@ namespace SierraBreeze
         //* detection dialog
         DetectDialog* m_detectDialog = nullptr;
 
+        //* delays pattern analysis while typing
+        QTimer* m_analysisTimer = nullptr;
+
+        //* running pattern analysis
+        QFutureWatcher<PatternAnalyzer::Report> m_analysisWatcher;
+
         //* changed state
         bool m_changed = false;
 
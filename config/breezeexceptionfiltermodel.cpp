@@ -0,0 +1,99 @@
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breezeexceptionfiltermodel.h"
+#include "breezeexceptionmodel.h"
+
+namespace SierraBreeze
+{
+
+    //__________________________________________________________________
+    void ExceptionFilterModel::setSourceModel( QAbstractItemModel* model )
+    {
+        m_source = dynamic_cast<ExceptionModel*>( model );
+        QSortFilterProxyModel::setSourceModel( model );
+    }
+
+    //__________________________________________________________________
+    void ExceptionFilterModel::sort( int column, Qt::SortOrder order )
+    { if( sourceModel() ) sourceModel()->sort( column, order ); }
+
+    //__________________________________________________________________
+    void ExceptionFilterModel::setText( const QString& text )
+    {
+
+        if( text == m_text ) return;
+
+        /*
+        when the text only grows, as while typing, exceptions that did not contain
+        the previous text cannot contain the new one, and are rejected without comparing
+        */
+        m_narrowing = !m_text.isEmpty() && text.contains( m_text, Qt::CaseInsensitive );
+        m_previous.swap( m_current );
+        m_current.clear();
+        m_text = text;
+
+        invalidateRowsFilter();
+
+        m_narrowing = false;
+        m_previous.clear();
+
+    }
+
+    //__________________________________________________________________
+    void ExceptionFilterModel::setType( int type )
+    {
+        if( type == m_type ) return;
+        m_type = type;
+        m_current.clear();
+        invalidateRowsFilter();
+    }
+
+    //__________________________________________________________________
+    void ExceptionFilterModel::setEnabledState( int enabled )
+    {
+        if( enabled == m_enabled ) return;
+        m_enabled = enabled;
+        m_current.clear();
+        invalidateRowsFilter();
+    }
+
+    //__________________________________________________________________
+    bool ExceptionFilterModel::filterAcceptsRow( int sourceRow, const QModelIndex& ) const
+    {
+
+        if( !m_source || sourceRow >= m_source->rowCount() ) return false;
+        const InternalSettings* exception( m_source->get()[sourceRow].data() );
+
+        // text first, so that the accepted set is complete for the next, narrower, text
+        if( !m_text.isEmpty() )
+        {
+            if( m_narrowing && !m_previous.contains( exception ) ) return false;
+            if( !exception->exceptionPattern().contains( m_text, Qt::CaseInsensitive ) ) return false;
+            m_current.insert( exception );
+        }
+
+        if( m_type >= 0 && exception->exceptionType() != m_type ) return false;
+        if( m_enabled >= 0 && exception->enabled() != bool( m_enabled ) ) return false;
+        return true;
+
+    }
+
+}
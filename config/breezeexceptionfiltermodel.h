@@ -0,0 +1,100 @@
+#ifndef breezeexceptionfiltermodel_h
+#define breezeexceptionfiltermodel_h
+
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breeze.h"
+
+#include <QSet>
+#include <QSortFilterProxyModel>
+
+namespace SierraBreeze
+{
+
+    class ExceptionModel;
+
+    //* filters exceptions by pattern substring, type and enabled state. Rows keep the source order
+    class ExceptionFilterModel: public QSortFilterProxyModel
+    {
+
+        Q_OBJECT
+
+        public:
+
+        //* constructor
+        explicit ExceptionFilterModel( QObject* parent = nullptr ):
+            QSortFilterProxyModel( parent )
+        {}
+
+        //* source model
+        void setSourceModel( QAbstractItemModel* ) override;
+
+        //* sort, forwarded to the source, which keeps exceptions in priority order
+        void sort( int column, Qt::SortOrder order = Qt::AscendingOrder ) override;
+
+        //* true if some filter is set
+        bool isFiltering( void ) const
+        { return !m_text.isEmpty() || m_type >= 0 || m_enabled >= 0; }
+
+        public Q_SLOTS:
+
+        //* case insensitive substring of the pattern
+        void setText( const QString& );
+
+        //* exception type, -1 for all
+        void setType( int );
+
+        //* 1 for enabled exceptions, 0 for disabled ones, -1 for all
+        void setEnabledState( int );
+
+        protected:
+
+        //* filter
+        bool filterAcceptsRow( int sourceRow, const QModelIndex& sourceParent ) const override;
+
+        private:
+
+        //* source model
+        ExceptionModel* m_source = nullptr;
+
+        //* pattern substring
+        QString m_text;
+
+        //* exception type
+        int m_type = -1;
+
+        //* enabled state
+        int m_enabled = -1;
+
+        //* true while refiltering for a text that extends the previous one
+        bool m_narrowing = false;
+
+        //* exceptions whose pattern matched the previous text
+        QSet<const InternalSettings*> m_previous;
+
+        //* exceptions whose pattern matches the current text
+        mutable QSet<const InternalSettings*> m_current;
+
+    };
+
+}
+
+#endif
@@ -0,0 +1,247 @@
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breezeexceptionjson.h"
+#include "breezeexceptionmatcher.h"
+
+#include <KLocalizedString>
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QtConcurrent>
+
+namespace SierraBreeze
+{
+
+    namespace
+    {
+
+        //* exception types, indexed by InternalSettings::EnumExceptionType
+        const QLatin1String s_exceptionTypes[] =
+        {
+            QLatin1String( "WindowClassName" ),
+            QLatin1String( "WindowTitle" )
+        };
+
+        //* pattern kinds, indexed by InternalSettings::EnumExceptionPatternKind
+        const QLatin1String s_patternKinds[] =
+        {
+            QLatin1String( "RegExp" ),
+            QLatin1String( "Literal" ),
+            QLatin1String( "Glob" )
+        };
+
+        //* border sizes, indexed by InternalSettings::EnumBorderSize
+        const QLatin1String s_borderSizes[] =
+        {
+            QLatin1String( "None" ),
+            QLatin1String( "NoSides" ),
+            QLatin1String( "Tiny" ),
+            QLatin1String( "Normal" ),
+            QLatin1String( "Large" ),
+            QLatin1String( "VeryLarge" ),
+            QLatin1String( "Huge" ),
+            QLatin1String( "VeryHuge" ),
+            QLatin1String( "Oversized" )
+        };
+
+        //* index of a name in table, -1 if not found
+        template<int N>
+        int lookup( const QLatin1String (&table)[N], const QString& name )
+        {
+            for( int index = 0; index < N; ++index )
+            { if( name == table[index] ) return index; }
+            return -1;
+        }
+
+        //* parsed entry, independent from the settings objects so that it can be built in any thread
+        struct Entry
+        {
+            bool enabled = true;
+            int type = InternalSettings::ExceptionWindowClassName;
+            int kind = InternalSettings::PatternRegExp;
+            QString pattern;
+            bool hideTitleBar = false;
+            int borderSize = -1;
+
+            //* empty if accepted
+            QString reason;
+        };
+
+        //* parse and validate one entry
+        Entry parse( const QJsonValue& value )
+        {
+
+            Entry entry;
+            if( !value.isObject() )
+            {
+                entry.reason = i18n( "Entry is not an object" );
+                return entry;
+            }
+
+            const QJsonObject object( value.toObject() );
+            entry.pattern = object.value( QLatin1String( "ExceptionPattern" ) ).toString();
+            entry.enabled = object.value( QLatin1String( "Enabled" ) ).toBool( true );
+            entry.hideTitleBar = object.value( QLatin1String( "HideTitleBar" ) ).toBool( false );
+
+            const QJsonValue type( object.value( QLatin1String( "ExceptionType" ) ) );
+            if( !type.isUndefined() && ( entry.type = lookup( s_exceptionTypes, type.toString() ) ) < 0 )
+            {
+                entry.reason = i18n( "Unknown exception type \"%1\"", type.toString() );
+                return entry;
+            }
+
+            const QJsonValue kind( object.value( QLatin1String( "ExceptionPatternKind" ) ) );
+            if( !kind.isUndefined() && ( entry.kind = lookup( s_patternKinds, kind.toString() ) ) < 0 )
+            {
+                entry.reason = i18n( "Unknown pattern kind \"%1\"", kind.toString() );
+                return entry;
+            }
+
+            const QJsonValue borderSize( object.value( QLatin1String( "BorderSize" ) ) );
+            if( !borderSize.isUndefined() && ( entry.borderSize = lookup( s_borderSizes, borderSize.toString() ) ) < 0 )
+            {
+                entry.reason = i18n( "Unknown border size \"%1\"", borderSize.toString() );
+                return entry;
+            }
+
+            if( entry.pattern.isEmpty() )
+            {
+                entry.reason = i18n( "Empty pattern" );
+                return entry;
+            }
+
+            // compile, as the decoration would
+            const QRegularExpression expression( ExceptionMatcher::regularExpression( entry.pattern, entry.kind ) );
+            if( !expression.isValid() )
+            { entry.reason = i18n( "Invalid regular expression at offset %1: %2", expression.patternErrorOffset(), expression.errorString() ); }
+
+            return entry;
+
+        }
+
+    }
+
+    //______________________________________________________________
+    ExceptionJson::Result ExceptionJson::read( const QString& fileName )
+    {
+
+        Result result;
+
+        QFile file( fileName );
+        if( !file.open( QIODevice::ReadOnly ) )
+        {
+            result.error = file.errorString();
+            return result;
+        }
+
+        // parse straight from the mapped file, without copying it
+        const qint64 size( file.size() );
+        uchar* data( size > 0 ? file.map( 0, size ) : nullptr );
+        const QByteArray content( data ?
+            QByteArray::fromRawData( reinterpret_cast<const char*>( data ), size ) :
+            file.readAll() );
+
+        QJsonParseError parseError;
+        const QJsonDocument document( QJsonDocument::fromJson( content, &parseError ) );
+        if( data ) file.unmap( data );
+
+        if( document.isNull() )
+        {
+            result.error = i18n( "Parse error at offset %1: %2", parseError.offset, parseError.errorString() );
+            return result;
+        }
+
+        // either the exception array itself, or an object holding it
+        const QJsonArray array( document.isArray() ?
+            document.array() :
+            document.object().value( QLatin1String( "exceptions" ) ).toArray() );
+
+        // regular expression compilation dominates, and entries are independent
+        const QList<QJsonValue> values( array.begin(), array.end() );
+        const QList<Entry> entries( QtConcurrent::blockingMapped( values, parse ) );
+
+        // settings objects are created in the calling thread
+        for( int index = 0; index < entries.size(); ++index )
+        {
+
+            const Entry& entry( entries[index] );
+            if( !entry.reason.isEmpty() )
+            {
+                result.rejections.append( { index, entry.pattern, entry.reason } );
+                continue;
+            }
+
+            // start from the defaults, as exceptions read from the configuration do
+            InternalSettingsPtr exception( new InternalSettings() );
+            exception->load();
+
+            exception->setEnabled( entry.enabled );
+            exception->setExceptionType( entry.type );
+            exception->setExceptionPattern( entry.pattern );
+            exception->setExceptionPatternKind( entry.kind );
+            exception->setHideTitleBar( entry.hideTitleBar );
+            exception->setMask( entry.borderSize >= 0 ? BorderSize : None );
+            if( entry.borderSize >= 0 ) exception->setBorderSize( entry.borderSize );
+
+            result.exceptions.append( exception );
+
+        }
+
+        return result;
+
+    }
+
+    //______________________________________________________________
+    QString ExceptionJson::write( const QString& fileName, const InternalSettingsList& exceptions )
+    {
+
+        QJsonArray array;
+        for( const InternalSettingsPtr& exception : exceptions )
+        {
+
+            QJsonObject object;
+            object.insert( QLatin1String( "Enabled" ), exception->enabled() );
+            object.insert( QLatin1String( "ExceptionType" ), s_exceptionTypes[ qBound( 0, exception->exceptionType(), 1 ) ] );
+            object.insert( QLatin1String( "ExceptionPattern" ), exception->exceptionPattern() );
+            object.insert( QLatin1String( "ExceptionPatternKind" ), s_patternKinds[ qBound( 0, exception->exceptionPatternKind(), 2 ) ] );
+            object.insert( QLatin1String( "HideTitleBar" ), exception->hideTitleBar() );
+            if( exception->mask() & BorderSize )
+            { object.insert( QLatin1String( "BorderSize" ), s_borderSizes[ qBound( 0, exception->borderSize(), 8 ) ] ); }
+
+            array.append( object );
+
+        }
+
+        QSaveFile file( fileName );
+        if( !file.open( QIODevice::WriteOnly ) ) return file.errorString();
+
+        file.write( QJsonDocument( QJsonObject{ { QLatin1String( "exceptions" ), array } } ).toJson() );
+        if( !file.commit() ) return file.errorString();
+
+        return QString();
+
+    }
+
+}
@@ -0,0 +1,79 @@
+#ifndef breezeexceptionjson_h
+#define breezeexceptionjson_h
+
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breeze.h"
+
+#include <QList>
+#include <QString>
+
+namespace SierraBreeze
+{
+
+    //* import and export of the exception list, as json
+    /**
+    the file holds an "exceptions" array, in priority order. Each entry uses the configuration keys:
+    Enabled, ExceptionType (WindowClassName or WindowTitle), ExceptionPattern, ExceptionPatternKind (RegExp, Literal or Glob), HideTitleBar and,
+    to override the border size, BorderSize (None, NoSides, Tiny, Normal, Large, VeryLarge, Huge, VeryHuge, Oversized).
+    */
+    class ExceptionJson
+    {
+
+        public:
+
+        //* entry that could not be imported
+        struct Rejection
+        {
+            //* position in the file's exception array
+            int entry = 0;
+
+            //* pattern, possibly empty
+            QString pattern;
+
+            //* translated reason
+            QString reason;
+        };
+
+        //* import result
+        struct Result
+        {
+            //* file level error, if the file could not be read at all
+            QString error;
+
+            //* accepted exceptions, in file order
+            InternalSettingsList exceptions;
+
+            //* rejected entries, in file order
+            QList<Rejection> rejections;
+        };
+
+        //* read exceptions from file. Entries are validated in parallel
+        static Result read( const QString& fileName );
+
+        //* write exceptions to file. Returns an error message on failure, empty on success
+        static QString write( const QString& fileName, const InternalSettingsList& );
+
+    };
+
+}
+
+#endif
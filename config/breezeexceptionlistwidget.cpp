@@ -25,12 +25,23 @@
 
 #include "breezeexceptionlistwidget.h"
 #include "breezeexceptiondialog.h"
+#include "breezeexceptionjson.h"
+#include "breezeexceptionmatcher.h"
+#include "breezepatternanalyzer.h"
+#include "breezeruleanalyzer.h"
 
 #include <KLocalizedString>
 
+#include <QEventLoop>
+#include <QFileDialog>
+#include <QFutureWatcher>
 #include <QMessageBox>
 #include <QPointer>
 #include <QIcon>
+#include <QTimer>
+#include <QtConcurrent>
+
+#include <algorithm>
 #include <qregularexpression.h>
 
 //__________________________________________________________
@@ -49,7 +60,8 @@ namespace SierraBreeze
         m_ui.exceptionListView->setAllColumnsShowFocus( true );
         m_ui.exceptionListView->setRootIsDecorated( false );
         m_ui.exceptionListView->setSortingEnabled( false );
-        m_ui.exceptionListView->setModel( &model() );
+        m_filter.setSourceModel( &model() );
+        m_ui.exceptionListView->setModel( &m_filter );
         m_ui.exceptionListView->sortByColumn( ExceptionModel::ColumnType, Qt::SortOrder::AscendingOrder );
         m_ui.exceptionListView->setSizePolicy( QSizePolicy( QSizePolicy::MinimumExpanding, QSizePolicy::Ignored ) );
 
@@ -58,17 +70,32 @@ namespace SierraBreeze
         m_ui.addButton->setIcon( QIcon::fromTheme( QStringLiteral( "list-add" ) ) );
         m_ui.removeButton->setIcon( QIcon::fromTheme( QStringLiteral( "list-remove" ) ) );
         m_ui.editButton->setIcon( QIcon::fromTheme( QStringLiteral( "edit-rename" ) ) );
+        m_ui.importButton->setIcon( QIcon::fromTheme( QStringLiteral( "document-import" ) ) );
+        m_ui.exportButton->setIcon( QIcon::fromTheme( QStringLiteral( "document-export" ) ) );
+        m_ui.checkButton->setIcon( QIcon::fromTheme( QStringLiteral( "tools-check-spelling" ) ) );
 
         connect( m_ui.addButton, SIGNAL(clicked()), SLOT(add()) );
         connect( m_ui.editButton, SIGNAL(clicked()), SLOT(edit()) );
         connect( m_ui.removeButton, SIGNAL(clicked()), SLOT(remove()) );
         connect( m_ui.moveUpButton, SIGNAL(clicked()), SLOT(up()) );
         connect( m_ui.moveDownButton, SIGNAL(clicked()), SLOT(down()) );
+        connect( m_ui.importButton, SIGNAL(clicked()), SLOT(importExceptions()) );
+        connect( m_ui.exportButton, SIGNAL(clicked()), SLOT(exportExceptions()) );
+        connect( m_ui.checkButton, SIGNAL(clicked()), SLOT(checkExceptions()) );
 
         connect( m_ui.exceptionListView, SIGNAL(activated(QModelIndex)), SLOT(edit()) );
         connect( m_ui.exceptionListView, SIGNAL(clicked(QModelIndex)), SLOT(toggle(QModelIndex)) );
         connect( m_ui.exceptionListView->selectionModel(), SIGNAL(selectionChanged(QItemSelection,QItemSelection)), SLOT(updateButtons()) );
 
+        // filters
+        connect( m_ui.filterEditor, &QLineEdit::textChanged, &m_filter, &ExceptionFilterModel::setText );
+        connect( m_ui.filterType, qOverload<int>( &QComboBox::currentIndexChanged ), &m_filter,
+            [this]( int index ) { m_filter.setType( index - 1 ); } );
+        connect( m_ui.filterState, qOverload<int>( &QComboBox::currentIndexChanged ), &m_filter,
+            [this]( int index ) { m_filter.setEnabledState( index == 0 ? -1 : index == 1 ? 1 : 0 ); } );
+        connect( &m_filter, &QAbstractItemModel::rowsRemoved, this, &ExceptionListWidget::updateButtons );
+        connect( &m_filter, &QAbstractItemModel::rowsInserted, this, &ExceptionListWidget::updateButtons );
+
         updateButtons();
         resizeColumns();
 
@@ -80,6 +107,7 @@ namespace SierraBreeze
     {
         model().set( exceptions );
         resizeColumns();
+        updateButtons();
         setChanged( false );
     }
 
@@ -99,7 +127,9 @@ namespace SierraBreeze
         m_ui.editButton->setEnabled( hasSelection );
 
         m_ui.moveUpButton->setEnabled( hasSelection && !m_ui.exceptionListView->selectionModel()->isRowSelected( 0, QModelIndex() ) );
-        m_ui.moveDownButton->setEnabled( hasSelection && !m_ui.exceptionListView->selectionModel()->isRowSelected( model().rowCount()-1, QModelIndex() ) );
+        m_ui.moveDownButton->setEnabled( hasSelection && !m_ui.exceptionListView->selectionModel()->isRowSelected( m_filter.rowCount()-1, QModelIndex() ) );
+        m_ui.exportButton->setEnabled( model().rowCount() > 0 );
+        m_ui.checkButton->setEnabled( model().rowCount() > 0 );
 
     }
 
@@ -134,8 +164,8 @@ namespace SierraBreeze
         model().add( exception );
         setChanged( true );
 
-        // make sure item is selected
-        QModelIndex index( model().index( exception ) );
+        // make sure item is selected, if it passes the filters
+        QModelIndex index( m_filter.mapFromSource( model().index( exception ) ) );
         if( index != m_ui.exceptionListView->selectionModel()->currentIndex() )
         {
             m_ui.exceptionListView->selectionModel()->select( index,  QItemSelectionModel::Clear|QItemSelectionModel::Select|QItemSelectionModel::Rows );
@@ -152,7 +182,7 @@ namespace SierraBreeze
     {
 
         // retrieve selection
-        QModelIndex current( m_ui.exceptionListView->selectionModel()->currentIndex() );
+        QModelIndex current( m_filter.mapToSource( m_ui.exceptionListView->selectionModel()->currentIndex() ) );
         if( ! model().contains( current ) ) return;
 
         InternalSettingsPtr exception( model().get( current ) );
@@ -178,6 +208,7 @@ namespace SierraBreeze
 
         // check new exception validity
         checkException( exception );
+        if( m_filter.isFiltering() ) m_filter.invalidate();
         resizeColumns();
 
         setChanged( true );
@@ -199,7 +230,9 @@ namespace SierraBreeze
         }
 
         // remove
-        model().remove( model().get( m_ui.exceptionListView->selectionModel()->selectedRows() ) );
+        QModelIndexList indexes( m_ui.exceptionListView->selectionModel()->selectedRows() );
+        for( QModelIndex& index : indexes ) index = m_filter.mapToSource( index );
+        model().remove( model().get( indexes ) );
         resizeColumns();
         updateButtons();
 
@@ -210,15 +243,17 @@ namespace SierraBreeze
     }
 
     //_______________________________________________________
-    void ExceptionListWidget::toggle( const QModelIndex& index )
+    void ExceptionListWidget::toggle( const QModelIndex& filterIndex )
     {
 
+        const QModelIndex index( m_filter.mapToSource( filterIndex ) );
         if( !model().contains( index ) ) return;
         if( index.column() != ExceptionModel::ColumnEnabled ) return;
 
         // get matching exception
         InternalSettingsPtr exception( model().get( index ) );
         exception->setEnabled( !exception->enabled() );
+        if( m_filter.isFiltering() ) m_filter.invalidate();
         setChanged( true );
         return;
 
@@ -228,42 +263,45 @@ namespace SierraBreeze
     void ExceptionListWidget::up( void )
     {
 
-        InternalSettingsList selection( model().get( m_ui.exceptionListView->selectionModel()->selectedRows() ) );
-        if( selection.empty() ) { return; }
+        const QList<QPair<int,int>> blocks( selectedBlocks() );
+        if( blocks.empty() ) { return; }
 
-        // retrieve selected indexes in list and store in model
-        QModelIndexList selectedIndices( m_ui.exceptionListView->selectionModel()->selectedRows() );
-        InternalSettingsList selectedExceptions( model().get( selectedIndices ) );
+        /*
+        the visible row above each block goes right below it. Rows are moved in place,
+        so that the view keeps the selection, and hidden rows stay where they are
+        */
+        for( const auto& block : blocks )
+        {
+            if( block.first == 0 ) continue;
+            const int from( m_filter.mapToSource( m_filter.index( block.first - 1, 0 ) ).row() );
+            const int to( m_filter.mapToSource( m_filter.index( block.second, 0 ) ).row() + 1 );
+            model().move( from, to );
+        }
 
-        InternalSettingsList currentException( model().get() );
-        InternalSettingsList newExceptions;
+        updateButtons();
+        setChanged( true );
 
-        for( InternalSettingsList::const_iterator iter = currentException.constBegin(); iter != currentException.constEnd(); ++iter )
-        {
+        return;
 
-            // check if new list is not empty, current index is selected and last index is not.
-            // if yes, move.
-            if(
-                !( newExceptions.empty() ||
-                selectedIndices.indexOf( model().index( *iter ) ) == -1 ||
-                selectedIndices.indexOf( model().index( newExceptions.back() ) ) != -1
-                ) )
-            {
-                InternalSettingsPtr last( newExceptions.back() );
-                newExceptions.removeLast();
-                newExceptions.append( *iter );
-                newExceptions.append( last );
-            } else newExceptions.append( *iter );
+    }
 
-        }
+    //_______________________________________________________
+    void ExceptionListWidget::down( void )
+    {
 
-        model().set( newExceptions );
+        const QList<QPair<int,int>> blocks( selectedBlocks() );
+        if( blocks.empty() ) { return; }
 
-        // restore selection
-        m_ui.exceptionListView->selectionModel()->select( model().index( selectedExceptions.front() ),  QItemSelectionModel::Clear|QItemSelectionModel::Select|QItemSelectionModel::Rows );
-        for( InternalSettingsList::const_iterator iter = selectedExceptions.constBegin(); iter != selectedExceptions.constEnd(); ++iter )
-        { m_ui.exceptionListView->selectionModel()->select( model().index( *iter ), QItemSelectionModel::Select|QItemSelectionModel::Rows ); }
+        // the visible row below each block goes right above it
+        for( const auto& block : blocks )
+        {
+            if( block.second == m_filter.rowCount() - 1 ) continue;
+            const int from( m_filter.mapToSource( m_filter.index( block.second + 1, 0 ) ).row() );
+            const int to( m_filter.mapToSource( m_filter.index( block.first, 0 ) ).row() );
+            model().move( from, to );
+        }
 
+        updateButtons();
         setChanged( true );
 
         return;
@@ -271,54 +309,197 @@ namespace SierraBreeze
     }
 
     //_______________________________________________________
-    void ExceptionListWidget::down( void )
+    void ExceptionListWidget::importExceptions( void )
     {
 
-        InternalSettingsList selection( model().get( m_ui.exceptionListView->selectionModel()->selectedRows() ) );
-        if( selection.empty() )
-        { return; }
+        const QString fileName( QFileDialog::getOpenFileName( this, i18n( "Import Exceptions - Breeze Settings" ), QString(), i18n( "JSON files (*.json)" ) ) );
+        if( fileName.isEmpty() ) return;
 
-        // retrieve selected indexes in list and store in model
-        QModelIndexList selectedIndices( m_ui.exceptionListView->selectionModel()->selectedIndexes() );
-        InternalSettingsList selectedExceptions( model().get( selectedIndices ) );
+        const ExceptionJson::Result result( ExceptionJson::read( fileName ) );
+        if( !result.error.isEmpty() )
+        {
+            QMessageBox::warning( this, i18n( "Warning - Breeze Settings" ), i18n( "Unable to import %1: %2", fileName, result.error ) );
+            return;
+        }
+
+        // imported exceptions go after existing ones, keeping their order
+        if( !result.exceptions.isEmpty() )
+        {
+            model().add( result.exceptions );
+            resizeColumns();
+            updateButtons();
+            setChanged( true );
+        }
+
+        if( result.rejections.isEmpty() ) return;
+
+        // detailed report of rejected entries
+        QStringList report;
+        for( const auto& rejection : result.rejections )
+        { report.append( i18n( "Entry %1, \"%2\": %3", rejection.entry + 1, rejection.pattern, rejection.reason ) ); }
+
+        QMessageBox messageBox( QMessageBox::Warning, i18n( "Warning - Breeze Settings" ),
+            i18np( "%1 entry could not be imported.", "%1 entries could not be imported.", result.rejections.size() ),
+            QMessageBox::Ok, this );
+        messageBox.setDetailedText( report.join( QLatin1Char( '\n' ) ) );
+        messageBox.exec();
+
+    }
 
-        InternalSettingsList currentExceptions( model().get() );
-        InternalSettingsList newExceptions;
+    //_______________________________________________________
+    void ExceptionListWidget::exportExceptions( void )
+    {
+
+        const QString fileName( QFileDialog::getSaveFileName( this, i18n( "Export Exceptions - Breeze Settings" ), QString(), i18n( "JSON files (*.json)" ) ) );
+        if( fileName.isEmpty() ) return;
+
+        const QString error( ExceptionJson::write( fileName, model().get() ) );
+        if( !error.isEmpty() )
+        { QMessageBox::warning( this, i18n( "Warning - Breeze Settings" ), i18n( "Unable to export %1: %2", fileName, error ) ); }
+
+    }
+
+    //_______________________________________________________
+    void ExceptionListWidget::checkExceptions( void )
+    {
 
-        InternalSettingsListIterator iter( currentExceptions );
-        iter.toBack();
-        while( iter.hasPrevious() )
+        const InternalSettingsList exceptions( model().get() );
+        const QList<RuleAnalyzer::Finding> findings( RuleAnalyzer::analyze( exceptions ) );
+
+        /*
+        exceptions hidden by a pattern the decoration refuses as too expensive do apply, so they are not reported,
+        as in the decoration. Only certain findings are offered for removal
+        */
+        QSet<int> causes;
+        for( const auto& finding : findings )
+        { if( finding.cause >= 0 ) causes.insert( finding.cause ); }
+        const QSet<int> refused( refusedExceptions( exceptions, causes ) );
+
+        QStringList removable;
+        QStringList possiblyHidden;
+        InternalSettingsList unreachable;
+        for( const auto& finding : findings )
         {
 
-            InternalSettingsPtr current( iter.previous() );
+            if( finding.cause >= 0 && refused.contains( finding.cause ) ) continue;
 
-            // check if new list is not empty, current index is selected and last index is not.
-            // if yes, move.
-            if(
-                !( newExceptions.empty() ||
-                selectedIndices.indexOf( model().index( current ) ) == -1 ||
-                selectedIndices.indexOf( model().index( newExceptions.front() ) ) != -1
-                ) )
+            const QString pattern( exceptions[finding.index]->exceptionPattern() );
+            switch( finding.issue )
             {
+                case RuleAnalyzer::Inactive:
+                removable.append( i18n( "Exception %1, \"%2\": disabled, empty or invalid", finding.index + 1, pattern ) );
+                break;
+
+                case RuleAnalyzer::Duplicate:
+                removable.append( i18n( "Exception %1, \"%2\": duplicate of exception %3", finding.index + 1, pattern, finding.cause + 1 ) );
+                break;
+
+                case RuleAnalyzer::Shadowed:
+                if( !finding.universalCause )
+                {
+                    possiblyHidden.append( i18n( "Exception %1, \"%2\": possibly hidden by exception %3, \"%4\"", finding.index + 1, pattern, finding.cause + 1, exceptions[finding.cause]->exceptionPattern() ) );
+                    continue;
+                }
+
+                removable.append( i18n( "Exception %1, \"%2\": hidden by exception %3, \"%4\", which matches any window", finding.index + 1, pattern, finding.cause + 1, exceptions[finding.cause]->exceptionPattern() ) );
+                break;
+            }
+
+            unreachable.append( exceptions[finding.index] );
 
-                InternalSettingsPtr first( newExceptions.front() );
-                newExceptions.removeFirst();
-                newExceptions.prepend( current );
-                newExceptions.prepend( first );
+        }
 
-            } else newExceptions.prepend( current );
+        if( removable.isEmpty() && possiblyHidden.isEmpty() )
+        {
+            QMessageBox::information( this, i18n( "Information - Breeze Settings" ), i18n( "Every exception can apply." ) );
+            return;
         }
 
-        model().set( newExceptions );
+        // exceptions that are only possibly hidden are listed, but kept
+        QStringList report( removable );
+        if( !possiblyHidden.isEmpty() )
+        {
+            if( !report.isEmpty() ) report.append( QString() );
+            report.append( i18n( "Possibly hidden by an earlier exception, kept:" ) );
+            report.append( possiblyHidden );
+        }
 
-        // restore selection
-        m_ui.exceptionListView->selectionModel()->select( model().index( selectedExceptions.front() ),  QItemSelectionModel::Clear|QItemSelectionModel::Select|QItemSelectionModel::Rows );
-        for( InternalSettingsList::const_iterator iter = selectedExceptions.constBegin(); iter != selectedExceptions.constEnd(); ++iter )
-        { m_ui.exceptionListView->selectionModel()->select( model().index( *iter ), QItemSelectionModel::Select|QItemSelectionModel::Rows ); }
+        if( removable.isEmpty() )
+        {
+            QMessageBox messageBox( QMessageBox::Information, i18n( "Information - Breeze Settings" ),
+                i18np( "%1 exception may be hidden by an earlier one. Check it by hand.", "%1 exceptions may be hidden by earlier ones. Check them by hand.", possiblyHidden.size() ),
+                QMessageBox::Ok, this );
+            messageBox.setDetailedText( report.join( QLatin1Char( '\n' ) ) );
+            messageBox.exec();
+            return;
+        }
+
+        QMessageBox messageBox( QMessageBox::Question, i18n( "Question - Breeze Settings" ),
+            i18np( "%1 exception can never apply. Remove it?", "%1 exceptions can never apply. Remove them?", removable.size() ),
+            QMessageBox::Yes | QMessageBox::Cancel, this );
+        messageBox.button( QMessageBox::Yes )->setText( i18n( "Remove" ) );
+        messageBox.setDefaultButton( QMessageBox::Cancel );
+        messageBox.setDetailedText( report.join( QLatin1Char( '\n' ) ) );
+        if( messageBox.exec() == QMessageBox::Cancel ) return;
+
+        model().remove( unreachable );
+        resizeColumns();
+        updateButtons();
 
         setChanged( true );
 
-        return;
+    }
+
+    //_______________________________________________________
+    QSet<int> ExceptionListWidget::refusedExceptions( const InternalSettingsList& exceptions, const QSet<int>& indices )
+    {
+
+        // same selection as the decoration: only enabled regular expressions with risky constructs are timed
+        QSet<int> refused;
+        for( int index : indices )
+        {
+
+            const auto& exception( exceptions[index] );
+            const QString pattern( exception->exceptionPattern() );
+            if( !exception->enabled() || pattern.isEmpty() ) continue;
+            if( exception->exceptionPatternKind() != InternalSettings::PatternRegExp ) continue;
+            if( !PatternAnalyzer::hazards( pattern ) ) continue;
+
+            // in the background, with the deadline of the decoration, so that a catastrophic pattern does not freeze the module
+            QFutureWatcher<PatternAnalyzer::Report> watcher;
+            QEventLoop loop;
+            connect( &watcher, &QFutureWatcher<PatternAnalyzer::Report>::finished, &loop, &QEventLoop::quit );
+            QTimer::singleShot( PatternAnalyzer::AnalysisDeadline, &loop, &QEventLoop::quit );
+            watcher.setFuture( QtConcurrent::run( &PatternAnalyzer::analyze, pattern, exception->exceptionType() ) );
+            loop.exec( QEventLoop::ExcludeUserInputEvents );
+
+            if( !watcher.isFinished() || watcher.result().isOverBudget() ) refused.insert( index );
+
+        }
+
+        return refused;
+
+    }
+
+    //_______________________________________________________
+    QList<QPair<int,int>> ExceptionListWidget::selectedBlocks( void ) const
+    {
+
+        QList<int> rows;
+        const QModelIndexList indexes( m_ui.exceptionListView->selectionModel()->selectedRows() );
+        for( const QModelIndex& index : indexes )
+        { rows.append( index.row() ); }
+
+        std::sort( rows.begin(), rows.end() );
+
+        QList<QPair<int,int>> out;
+        for( int row : std::as_const( rows ) )
+        {
+            if( !out.isEmpty() && out.back().second == row - 1 ) out.back().second = row;
+            else out.append( qMakePair( row, row ) );
+        }
+
+        return out;
 
     }
 
@@ -334,7 +515,7 @@ namespace SierraBreeze
     bool ExceptionListWidget::checkException( InternalSettingsPtr exception )
     {
 
-        while( exception->exceptionPattern().isEmpty() || !QRegularExpression( exception->exceptionPattern() ).isValid() )
+        while( exception->exceptionPattern().isEmpty() || !QRegularExpression( ExceptionMatcher::regularExpression( exception->exceptionPattern(), exception->exceptionPatternKind() ) ).isValid() )
         {
 
             QMessageBox::warning( this, i18n( "Warning - Breeze Settings" ), i18n("Regular Expression syntax is incorrect") );
@@ -26,8 +26,11 @@
 //////////////////////////////////////////////////////////////////////////////
 
 #include "ui_breezeexceptionlistwidget.h"
+#include "breezeexceptionfiltermodel.h"
 #include "breezeexceptionmodel.h"
 
+#include <QSet>
+
 //* QDialog used to commit selected files
 namespace SierraBreeze
 {
@@ -91,14 +94,29 @@ namespace SierraBreeze
         //* move down
         virtual void down( void );
 
+        //* append exceptions read from a json file
+        virtual void importExceptions( void );
+
+        //* write exceptions to a json file
+        virtual void exportExceptions( void );
+
+        //* find exceptions that can never apply, and offer to remove them. Exceptions that are possibly hidden are only listed
+        virtual void checkExceptions( void );
+
         protected:
 
         //* resize columns
         void resizeColumns( void ) const;
 
+        //* selected rows of the filtered list, grouped in contiguous blocks, as first and last row
+        QList<QPair<int,int>> selectedBlocks( void ) const;
+
         //* check exception
         bool checkException( InternalSettingsPtr );
 
+        //* exceptions among given indices whose pattern the decoration refuses as too expensive to match
+        QSet<int> refusedExceptions( const InternalSettingsList&, const QSet<int>& );
+
         //* set changed state
         virtual void setChanged( bool value )
         {
@@ -111,6 +129,9 @@ namespace SierraBreeze
         //* model
         ExceptionModel m_model;
 
+        //* filtered model, shown in the list
+        ExceptionFilterModel m_filter;
+
         //* ui
         // Ui_BreezeExceptionListWidget m_ui;
         Ui_SierraBreezeExceptionListWidget m_ui;
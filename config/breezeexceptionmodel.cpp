@@ -35,9 +35,17 @@ namespace SierraBreeze
     {
         QStringLiteral( "" ),
         i18n("Exception Type"),
-        i18n("Regular Expression")
+        i18n("Pattern")
     };
 
+    //__________________________________________________________________
+    ExceptionModel::ExceptionModel( QObject* parent ):
+        ListModel<InternalSettingsPtr>( parent ),
+        m_windowTitle( i18n( "Window Title" ) ),
+        m_windowClassName( i18n( "Window Class Name" ) ),
+        m_enabledToolTip( i18n( "Enable/disable this exception" ) )
+    {}
+
     //__________________________________________________________________
     QVariant ExceptionModel::data( const QModelIndex& index, int role ) const
     {
@@ -45,8 +53,9 @@ namespace SierraBreeze
         // check index, role and column
         if( !index.isValid() ) return QVariant();
 
-        // retrieve associated file info
-        const InternalSettingsPtr& configuration( get(index) );
+        // retrieve associated file info, without copying the shared pointer
+        if( index.row() >= rowCount() ) return QVariant();
+        const InternalSettingsPtr& configuration( get()[index.row()] );
 
         // return text associated to file and column
         if( role == Qt::DisplayRole )
@@ -60,11 +69,11 @@ namespace SierraBreeze
                     {
 
                         case InternalSettings::ExceptionWindowTitle:
-                        return i18n( "Window Title" );
+                        return m_windowTitle;
 
                         default:
                         case InternalSettings::ExceptionWindowClassName:
-                        return i18n( "Window Class Name" );
+                        return m_windowClassName;
                     }
 
                 }
@@ -80,7 +89,7 @@ namespace SierraBreeze
 
         } else if( role == Qt::ToolTipRole &&  index.column() == ColumnEnabled ) {
 
-            return i18n("Enable/disable this exception");
+            return m_enabledToolTip;
 
         }
 
@@ -49,6 +49,9 @@ namespace SierraBreeze
         };
 
 
+        //* constructor
+        explicit ExceptionModel( QObject* parent = nullptr );
+
         //*@name methods reimplemented from base class
         //@{
 
@@ -75,6 +78,11 @@ namespace SierraBreeze
         //* column titles
         static const QString m_columnTitles[ nColumns ];
 
+        //* translated strings, looked up once rather than on every display request
+        QString m_windowTitle;
+        QString m_windowClassName;
+        QString m_enabledToolTip;
+
     };
 
 }
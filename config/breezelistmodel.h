@@ -27,6 +27,7 @@
 
 #include "breezeitemmodel.h"
 
+#include <QHash>
 #include <QSet>
 #include <QList>
 
@@ -99,6 +100,13 @@ namespace SierraBreeze
         int rowCount(const QModelIndex &parent = QModelIndex()) const override
         { return parent.isValid() ? 0:_values.size(); }
 
+        //! sort
+        void sort( int column, Qt::SortOrder order = Qt::AscendingOrder ) override
+        {
+            ItemModel::sort( column, order );
+            invalidateRows();
+        }
+
         //@}
 
         //!@name selection
@@ -141,6 +149,7 @@ namespace SierraBreeze
             emit layoutAboutToBeChanged();
             _add( value );
             privateSort();
+            invalidateRows();
             emit layoutChanged();
 
         }
@@ -159,6 +168,7 @@ namespace SierraBreeze
             { _add( *iter ); }
 
             privateSort();
+            invalidateRows();
             emit layoutChanged();
 
         }
@@ -195,6 +205,7 @@ namespace SierraBreeze
                 emit layoutAboutToBeChanged();
                 setIndexSelected( index, false );
                 _values[index.row()] = value;
+                invalidateRows();
                 setIndexSelected( index, true );
                 emit layoutChanged();
             }
@@ -220,13 +231,26 @@ namespace SierraBreeze
             if( values.empty() ) return;
 
             emit layoutAboutToBeChanged();
-            for( typename List::const_iterator iter = values.begin(); iter != values.end(); iter++ )
-            { _remove( *iter ); }
+            _remove( values );
             emit layoutChanged();
             return;
 
         }
 
+        //! move row from given position to before the row at given destination, as in beginMoveRows
+        virtual void move( int from, int to )
+        {
+
+            if( from == to || from + 1 == to ) return;
+
+            beginMoveRows( QModelIndex(), from, from, QModelIndex(), to );
+            const int target( to > from ? to - 1 : to );
+            _values.move( from, target );
+            updateRows( qMin( from, target ), qMax( from, target ) );
+            endMoveRows();
+
+        }
+
         //! clear
         virtual void clear( void )
         { set( List() ); }
@@ -241,6 +265,7 @@ namespace SierraBreeze
         {
 
             emit layoutAboutToBeChanged();
+            invalidateRows();
 
             // store values to be removed
             List removed_values;
@@ -268,6 +293,7 @@ namespace SierraBreeze
             { _add( *iter ); }
 
             privateSort();
+            invalidateRows();
             emit layoutChanged();
 
         }
@@ -280,6 +306,7 @@ namespace SierraBreeze
             _values = values;
             _selection.clear();
             privateSort();
+            invalidateRows();
             emit layoutChanged();
 
             return;
@@ -297,6 +324,9 @@ namespace SierraBreeze
         virtual ValueType& get( const QModelIndex& index )
         {
             Q_ASSERT( index.isValid() && index.row() < int( _values.size() ) );
+
+            // value might be modified through the reference
+            invalidateRows();
             return _values[index.row()];
         }
 
@@ -312,9 +342,8 @@ namespace SierraBreeze
         //! return index associated to a given value
         virtual QModelIndex index( const ValueType& value, int column = 0 ) const
         {
-            for( int row = 0; row < _values.size(); ++row )
-            { if( value == _values[row] ) return index( row, column ); }
-            return QModelIndex();
+            const int row( ListModel::row( value ) );
+            return row < 0 ? QModelIndex() : index( row, column );
         }
 
         //@}
@@ -327,14 +356,47 @@ namespace SierraBreeze
 
         //! return all values
         List& _get( void )
-        { return _values; }
+        {
+            invalidateRows();
+            return _values;
+        }
+
+        //! row of given value, -1 if not found. The first row wins for duplicated values
+        int row( const ValueType& value ) const
+        {
+            if( !_rowsValid )
+            {
+                _rows.clear();
+                _rows.reserve( _values.size() );
+                for( int row = _values.size() - 1; row >= 0; --row )
+                { _rows.insert( _values[row], row ); }
+                _rowsValid = true;
+            }
+
+            return _rows.value( value, -1 );
+        }
+
+        //! mark value to row lookup as outdated
+        void invalidateRows( void )
+        { _rowsValid = false; }
+
+        //! update value to row lookup for a range of rows whose values were permuted
+        void updateRows( int first, int last )
+        {
+            if( !_rowsValid ) return;
+            for( int row = first; row <= last; ++row )
+            { _rows.insert( _values[row], row ); }
+        }
 
         //! add, without update
         virtual void _add( const ValueType& value )
         {
-            typename List::iterator iter = std::find( _values.begin(), _values.end(), value );
-            if( iter == _values.end() ) _values.push_back( value );
-            else *iter = value;
+            const int row( ListModel::row( value ) );
+            if( row >= 0 ) _values[row] = value;
+            else {
+                _values.push_back( value );
+                _rows.insert( value, _values.size() - 1 );
+            }
         }
 
         //! add, without update
@@ -347,13 +409,26 @@ namespace SierraBreeze
             {}
 
             _values.insert( iter, value );
+            invalidateRows();
         }
 
         //! remove, without update
         virtual void _remove( const ValueType& value )
         {
+            if( row( value ) < 0 ) return;
             _values.erase( std::remove( _values.begin(), _values.end(), value ), _values.end() );
             _selection.erase( std::remove( _selection.begin(), _selection.end(), value ), _selection.end() );
+            invalidateRows();
+        }
+
+        //! remove, without update. Single pass over the list whatever the number of values
+        virtual void _remove( const List& values )
+        {
+            const QSet<ValueType> removed( values.begin(), values.end() );
+            const auto isRemoved = [&removed]( const ValueType& value ) { return removed.contains( value ); };
+            _values.erase( std::remove_if( _values.begin(), _values.end(), isRemoved ), _values.end() );
+            _selection.erase( std::remove_if( _selection.begin(), _selection.end(), isRemoved ), _selection.end() );
+            invalidateRows();
         }
 
         private:
@@ -361,6 +436,12 @@ namespace SierraBreeze
         //! values
         List _values;
 
+        //! row of each value, built on demand
+        mutable QHash<ValueType, int> _rows;
+
+        //! true if _rows is up to date
+        mutable bool _rowsValid = false;
+
         //! selection
         List _selection;
 
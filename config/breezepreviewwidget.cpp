@@ -0,0 +1,345 @@
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breezepreviewwidget.h"
+#include "breezeglyphregistry.h"
+#include "breezeglyphset.h"
+#include "breezerasterizer.h"
+#include "breezeshadowrenderer.h"
+
+#include <KConfigGroup>
+#include <KLocalizedString>
+#include <KSharedConfig>
+
+#include <QEvent>
+#include <QLinearGradient>
+#include <QPainter>
+
+#include <cmath>
+
+namespace SierraBreeze
+{
+
+    namespace
+    {
+
+        //* settings that only affect the shadow layer
+        bool isShadowItem( const QString& name )
+        {
+            return name == QLatin1String( "ShadowSize" ) ||
+                name == QLatin1String( "ShadowStrength" ) ||
+                name == QLatin1String( "ShadowColor" );
+        }
+
+        //* color of the marks shown on hover, as in Button
+        const QColor s_hintColor( 41, 43, 50, 200 );
+
+    }
+
+    //__________________________________________________________________
+    PreviewWidget::PreviewWidget( QWidget* parent ):
+        QWidget( parent ),
+        m_buttons( 256 )
+    {
+        setSizePolicy( QSizePolicy::Expanding, QSizePolicy::Fixed );
+        updateColors();
+    }
+
+    //__________________________________________________________________
+    void PreviewWidget::setSettings( InternalSettingsPtr settings )
+    {
+
+        m_settings = settings;
+        if( !m_settings ) return;
+
+        // split values between the layers they affect
+        QVariantList windowState;
+        QVariantList shadowState;
+        const auto items( m_settings->items() );
+        for( const KConfigSkeletonItem* item : items )
+        {
+            if( isShadowItem( item->name() ) ) shadowState.append( item->property() );
+            else windowState.append( item->property() );
+        }
+
+        if( shadowState != m_shadowState )
+        {
+            m_shadowState = shadowState;
+            m_shadow = QImage();
+            update();
+        }
+
+        if( windowState != m_windowState )
+        {
+            m_windowState = windowState;
+            if( GlyphRegistry::self().setGlyphSet( m_settings->glyphSet() ) ) m_buttons.clear();
+            m_windows[0] = QImage();
+            m_windows[1] = QImage();
+            update();
+        }
+
+    }
+
+    //__________________________________________________________________
+    QSize PreviewWidget::sizeHint( void ) const
+    { return QSize( 400, 12*fontMetrics().height() ); }
+
+    //__________________________________________________________________
+    void PreviewWidget::resizeEvent( QResizeEvent* event )
+    {
+        m_windows[0] = QImage();
+        m_windows[1] = QImage();
+        QWidget::resizeEvent( event );
+    }
+
+    //__________________________________________________________________
+    void PreviewWidget::changeEvent( QEvent* event )
+    {
+        if( event->type() == QEvent::PaletteChange || event->type() == QEvent::FontChange )
+        {
+            updateColors();
+            m_windows[0] = QImage();
+            m_windows[1] = QImage();
+            m_buttons.clear();
+        }
+
+        QWidget::changeEvent( event );
+    }
+
+    //__________________________________________________________________
+    void PreviewWidget::updateColors( void )
+    {
+
+        // same source as the colors kwin passes to the decoration
+        const KConfigGroup group( KSharedConfig::openConfig( QStringLiteral( "kdeglobals" ) ), QStringLiteral( "WM" ) );
+        m_titleBarColors[0] = group.readEntry( "inactiveBackground", palette().color( QPalette::Inactive, QPalette::Window ) );
+        m_titleBarColors[1] = group.readEntry( "activeBackground", palette().color( QPalette::Active, QPalette::Window ) );
+        m_fontColors[0] = group.readEntry( "inactiveForeground", palette().color( QPalette::Inactive, QPalette::WindowText ) );
+        m_fontColors[1] = group.readEntry( "activeForeground", palette().color( QPalette::Active, QPalette::WindowText ) );
+
+    }
+
+    //__________________________________________________________________
+    QRect PreviewWidget::windowRect( bool active ) const
+    {
+        const int margin( fontMetrics().height() );
+        const QSize size( width()*6/10, height() - 3*margin );
+        return active ?
+            QRect( QPoint( width() - margin - size.width(), 2*margin ), size ):
+            QRect( QPoint( margin, margin ), size );
+    }
+
+    //__________________________________________________________________
+    void PreviewWidget::paintEvent( QPaintEvent* )
+    {
+
+        if( !m_settings ) return;
+
+        QPainter painter( this );
+        for( const bool active : { false, true } )
+        {
+
+            const QRect rect( windowRect( active ) );
+            if( rect.isEmpty() ) continue;
+
+            if( m_shadow.isNull() ) m_shadow = ShadowRenderer::image( m_settings->shadowSize(), m_settings->shadowStrength(), m_settings->shadowColor() );
+            drawShadow( &painter, rect );
+
+            QImage& window( m_windows[active] );
+            if( window.isNull() || window.devicePixelRatio() != devicePixelRatioF() ) renderWindow( active );
+            painter.drawImage( rect.topLeft(), window );
+
+        }
+
+    }
+
+    //__________________________________________________________________
+    void PreviewWidget::drawShadow( QPainter* painter, const QRect& rect ) const
+    {
+
+        const int size( m_settings->shadowSize() );
+        if( size <= 0 || m_shadow.isNull() ) return;
+
+        // nine patch, the center pixel of the image being stretched along the edges, as done by kwin
+        const QRect outer( rect.marginsAdded( ShadowRenderer::padding( size ) ) );
+        const int innerWidth( qMax( 0, outer.width() - 2*size ) );
+        const int innerHeight( qMax( 0, outer.height() - 2*size ) );
+
+        painter->drawImage( QRect( outer.topLeft(), QSize( size, size ) ), m_shadow, QRect( 0, 0, size, size ) );
+        painter->drawImage( QRect( outer.right() - size + 1, outer.top(), size, size ), m_shadow, QRect( size, 0, size, size ) );
+        painter->drawImage( QRect( outer.left(), outer.bottom() - size + 1, size, size ), m_shadow, QRect( 0, size, size, size ) );
+        painter->drawImage( QRect( outer.right() - size + 1, outer.bottom() - size + 1, size, size ), m_shadow, QRect( size, size, size, size ) );
+
+        painter->drawImage( QRect( outer.left() + size, outer.top(), innerWidth, size ), m_shadow, QRect( size, 0, 1, size ) );
+        painter->drawImage( QRect( outer.left() + size, outer.bottom() - size + 1, innerWidth, size ), m_shadow, QRect( size, size, 1, size ) );
+        painter->drawImage( QRect( outer.left(), outer.top() + size, size, innerHeight ), m_shadow, QRect( 0, size, size, 1 ) );
+        painter->drawImage( QRect( outer.right() - size + 1, outer.top() + size, size, innerHeight ), m_shadow, QRect( size, size, size, 1 ) );
+
+    }
+
+    //__________________________________________________________________
+    void PreviewWidget::renderWindow( bool active )
+    {
+
+        const QRect rect( QPoint( 0, 0 ), windowRect( active ).size() );
+        const qreal devicePixelRatio( devicePixelRatioF() );
+
+        QImage& window( m_windows[active] );
+        window = QImage( rect.size()*devicePixelRatio, QImage::Format_ARGB32_Premultiplied );
+        window.setDevicePixelRatio( devicePixelRatio );
+        window.fill( Qt::transparent );
+
+        // metrics, as computed by the decoration from kwin's spacing
+        const QFontMetrics metrics( fontMetrics() );
+        const int gridUnit( metrics.height() );
+        const int smallSpacing( qMax( 2, gridUnit/4 ) );
+        const int buttonHeight( gridUnit + m_settings->buttonSize() );
+        const int titleHeight( qMax( metrics.height(), buttonHeight ) + smallSpacing*( Metrics::TitleBar_TopMargin + Metrics::TitleBar_BottomMargin ) + 1 );
+        const int bottom( qMax( 4, smallSpacing ) );
+
+        // titlebar color and opacity
+        QColor titleBarColor( m_settings->matchColorForTitleBar() ? palette().color( QPalette::Window ) : m_titleBarColors[active] );
+        if( !m_settings->opaqueTitleBar() ) titleBarColor.setAlpha( qRound( qBound( 0, m_settings->backgroundOpacity(), 100 )*2.55 ) );
+
+        QPainter painter( &window );
+        painter.setRenderHint( QPainter::Antialiasing );
+        painter.setPen( Qt::NoPen );
+
+        // frame
+        painter.setBrush( titleBarColor );
+        painter.drawRoundedRect( rect, Metrics::Frame_FrameRadius, Metrics::Frame_FrameRadius );
+
+        // titlebar gradient
+        const QRect titleRect( 0, 0, rect.width(), titleHeight );
+        if( active && m_settings->drawBackgroundGradient() )
+        {
+            QLinearGradient gradient( 0, 0, 0, titleRect.height() );
+            gradient.setColorAt( 0.0, titleBarColor.lighter( 120 ) );
+            gradient.setColorAt( 0.8, titleBarColor );
+            painter.setBrush( gradient );
+            painter.setClipRect( titleRect );
+            painter.drawRoundedRect( rect, Metrics::Frame_FrameRadius, Metrics::Frame_FrameRadius );
+            painter.setClipping( false );
+        }
+
+        // mock client
+        painter.setBrush( palette().color( QPalette::Base ) );
+        painter.drawRect( QRect( 0, titleHeight, rect.width(), rect.height() - titleHeight - bottom ) );
+
+        // separator
+        if( active && m_settings->drawTitleBarSeparator() )
+        {
+            painter.setRenderHint( QPainter::Antialiasing, false );
+            painter.setPen( palette().color( QPalette::Highlight ) );
+            painter.drawLine( titleRect.bottomLeft(), titleRect.bottomRight() );
+            painter.setRenderHint( QPainter::Antialiasing );
+        }
+
+        // buttons, close, minimize and maximize on the left
+        struct ButtonDefinition
+        {
+            QColor activeColor;
+            QColor inactiveColor;
+            int glyph;
+        };
+
+        const ButtonDefinition buttons[] =
+        {
+            { m_settings->buttonCloseActiveColor(), m_settings->buttonCloseInactiveColor(), GlyphRegistry::Cross },
+            { m_settings->buttonMinimizeActiveColor(), m_settings->buttonMinimizeInactiveColor(), GlyphRegistry::MinimizeLine },
+            { m_settings->buttonMaximizeActiveColor(), m_settings->buttonMaximizeInactiveColor(), GlyphRegistry::MaximizeTriangles }
+        };
+
+        int x( m_settings->buttonHPadding() );
+        const int y( smallSpacing*Metrics::TitleBar_TopMargin + ( titleHeight - smallSpacing*( Metrics::TitleBar_TopMargin + Metrics::TitleBar_BottomMargin ) - 1 - gridUnit )/2 );
+        for( const auto& button : buttons )
+        {
+            // the active window shows its marks, as when hovered
+            drawButton( &painter, QRect( x, y, gridUnit, gridUnit ), active ? button.activeColor : button.inactiveColor, active ? button.glyph : GlyphRegistry::NoGlyph );
+            x += gridUnit + m_settings->buttonSpacing();
+        }
+
+        // caption
+        const int captionLeft( x + Metrics::TitleBar_SideMargin*smallSpacing );
+        const QRect captionRect( captionLeft, 0, rect.width() - captionLeft - Metrics::TitleBar_SideMargin*smallSpacing, titleHeight );
+        Qt::Alignment alignment( Qt::AlignVCenter );
+        switch( m_settings->titleAlignment() )
+        {
+            case InternalSettings::AlignLeft: alignment |= Qt::AlignLeft; break;
+            case InternalSettings::AlignRight: alignment |= Qt::AlignRight; break;
+            default: alignment |= Qt::AlignHCenter; break;
+        }
+
+        painter.setFont( font() );
+        painter.setPen( m_fontColors[active] );
+        painter.drawText( captionRect, alignment | Qt::TextSingleLine,
+            metrics.elidedText( active ? i18n( "Active Window" ) : i18n( "Inactive Window" ), Qt::ElideMiddle, captionRect.width() ) );
+
+    }
+
+    //__________________________________________________________________
+    void PreviewWidget::drawButton( QPainter* painter, const QRect& rect, const QColor& color, int glyph )
+    {
+
+        const qreal devicePixelRatio( devicePixelRatioF() );
+        const quint64 key( quint64( color.rgba() ) | quint64( glyph ) << 32 | quint64( rect.width() ) << 40 );
+
+        const QImage* sprite( m_buttons.find( devicePixelRatio, key ) );
+        if( !sprite )
+        {
+
+            const int size( std::ceil( rect.width()*devicePixelRatio ) );
+            QImage image( size, size, QImage::Format_ARGB32_Premultiplied );
+            image.setDevicePixelRatio( devicePixelRatio );
+            image.fill( Qt::transparent );
+
+            // same geometry as Button: icon coordinates span QRect( -1, -1, 20, 20 )
+            const qreal scale( size/20.0 );
+            const QPointF origin( scale, scale );
+            Rasterizer::fillCircle( image, origin + QPointF( 9, 9 )*scale, 9*scale, color );
+
+            auto& registry( GlyphRegistry::self() );
+            const auto mark( GlyphRegistry::Glyph( glyph ) );
+            if( mark != GlyphRegistry::NoGlyph && registry.hasSvg( mark ) )
+            {
+
+                const QSize box( qRound( 18*scale ), qRound( 18*scale ) );
+                if( const QImage* svg = registry.svgImage( mark, box ) )
+                {
+                    QPainter imagePainter( &image );
+                    imagePainter.drawImage( QRectF( origin/devicePixelRatio, QSizeF( box )/devicePixelRatio ), *svg );
+                }
+
+            } else if( mark != GlyphRegistry::NoGlyph ) {
+
+                GlyphSet::self().render( image, mark, origin, scale, 1.5*qMax( 1.0, 20.0/rect.width() ), s_hintColor );
+
+            }
+
+            sprite = m_buttons.insert( key, image );
+            if( !sprite ) return;
+
+        }
+
+        painter->drawImage( rect.topLeft(), *sprite );
+
+    }
+
+}
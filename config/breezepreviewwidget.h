@@ -0,0 +1,113 @@
+#ifndef breezepreviewwidget_h
+#define breezepreviewwidget_h
+
+/*
+ * Copyright 2026  Sierra Breeze contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License or (at your option) version 3 or any later version
+ * accepted by the membership of KDE e.V. (or its successor approved
+ * by the membership of KDE e.V.), which shall act as a proxy
+ * defined in Section 14 of version 3 of the license.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "breeze.h"
+#include "breezerendercache.h"
+
+#include <QImage>
+#include <QVariantList>
+#include <QWidget>
+
+namespace SierraBreeze
+{
+
+    //* sample active and inactive windows, drawn with the settings being edited
+    /**
+    the windows are rendered with the plugin's own rasterizer, glyph set and shadow renderer.
+    Each layer is cached and only rendered again when a setting it depends on changes,
+    so that dragging a shadow slider does not repaint the windows, and the other way around.
+    */
+    class PreviewWidget: public QWidget
+    {
+
+        //* Qt meta object
+        Q_OBJECT
+
+        public:
+
+        //* constructor
+        explicit PreviewWidget( QWidget* = nullptr );
+
+        //* settings to preview. Must be called again when they change
+        void setSettings( InternalSettingsPtr );
+
+        //* size hint
+        QSize sizeHint( void ) const override;
+
+        protected:
+
+        //* paint
+        void paintEvent( QPaintEvent* ) override;
+
+        //* resize
+        void resizeEvent( QResizeEvent* ) override;
+
+        //* palette and font changes
+        void changeEvent( QEvent* ) override;
+
+        private:
+
+        //* window colors from the color scheme
+        void updateColors( void );
+
+        //* window geometry, in widget coordinates
+        QRect windowRect( bool active ) const;
+
+        //* render window layer for given active state
+        void renderWindow( bool active );
+
+        //* draw button at given position and size
+        void drawButton( QPainter*, const QRect&, const QColor&, int glyph );
+
+        //* draw shadow around window
+        void drawShadow( QPainter*, const QRect& ) const;
+
+        //* settings
+        InternalSettingsPtr m_settings;
+
+        //*@name values each layer depends on
+        //@{
+        QVariantList m_windowState;
+        QVariantList m_shadowState;
+        //@}
+
+        //*@name layers
+        //@{
+        QImage m_shadow;
+        QImage m_windows[2];
+        //@}
+
+        //*@name window manager colors, indexed by active state
+        //@{
+        QColor m_titleBarColors[2];
+        QColor m_fontColors[2];
+        //@}
+
+        //* buttons, keyed by color, glyph and size
+        RenderCache<quint64> m_buttons;
+
+    };
+
+}
+
+#endif